@@ -0,0 +1,152 @@
+#include "CompositeTransitionEffect.h"
+#include "ScreenBase.h"
+#include "Engine/World.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Materials/MaterialInterface.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Slate/WidgetRenderer.h"
+#include "Widgets/Images/SImage.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Misc/App.h"
+
+UCompositeTransitionEffect::UCompositeTransitionEffect()
+{
+	CompositeMaterial = nullptr;
+	SnapshotParameterName = TEXT("Snapshot");
+	ProgressParameterName = TEXT("Progress");
+	ModeParameterName = TEXT("Mode");
+	DirectionParameterName = TEXT("Direction");
+	OverlayZOrder = 1000;
+	SnapshotTarget = nullptr;
+	CompositeMID = nullptr;
+}
+
+void UCompositeTransitionEffect::StartTransition_Implementation(UScreenBase* FromScreen, UScreenBase* ToScreen)
+{
+	if (!CompositeMaterial || !FromScreen || !CaptureSnapshot(FromScreen))
+	{
+		Super::StartTransition_Implementation(FromScreen, ToScreen);
+		return;
+	}
+
+	// The outgoing screen is only visible through its snapshot from here on, so neither screen is touched per tick
+	Super::StartTransition_Implementation(nullptr, ToScreen);
+}
+
+void UCompositeTransitionEffect::TickTransition_Implementation(float Alpha)
+{
+	if (!CompositeMID)
+	{
+		Super::TickTransition_Implementation(Alpha);
+		return;
+	}
+
+	const float EasedAlpha = UKismetMathLibrary::Ease(0.0f, 1.0f, Alpha, EEasingFunc::EaseInOut);
+	CompositeMID->SetScalarParameterValue(ProgressParameterName, EasedAlpha);
+}
+
+void UCompositeTransitionEffect::ResetScreens()
+{
+	ReleaseSnapshot();
+
+	Super::ResetScreens();
+}
+
+bool UCompositeTransitionEffect::CaptureSnapshot(UScreenBase* Screen)
+{
+	if (!FApp::CanEverRender())
+	{
+		return false;
+	}
+
+	UWorld* World = GetWorld();
+	UGameViewportClient* ViewportClient = World ? World->GetGameViewport() : nullptr;
+	if (!ViewportClient)
+	{
+		return false;
+	}
+
+	FVector2D ViewportSize;
+	ViewportClient->GetViewportSize(ViewportSize);
+	if (ViewportSize.X <= 0.0f || ViewportSize.Y <= 0.0f)
+	{
+		return false;
+	}
+
+	const float ViewportScale = FMath::Max(UWidgetLayoutLibrary::GetViewportScale(World), KINDA_SMALL_NUMBER);
+
+	// Set up everything that can fail while the screen is still attached, so the fallback fade can still show it
+	CompositeMID = UMaterialInstanceDynamic::Create(CompositeMaterial, this);
+	SnapshotTarget = NewObject<UTextureRenderTarget2D>(this);
+	SnapshotTarget->ClearColor = FLinearColor::Transparent;
+	SnapshotTarget->InitAutoFormat(FMath::CeilToInt32(ViewportSize.X), FMath::CeilToInt32(ViewportSize.Y));
+	SnapshotTarget->UpdateResourceImmediate(true);
+
+	if (!CompositeMID || !SnapshotTarget->GameThread_GetRenderTargetResource())
+	{
+		CompositeMID = nullptr;
+		SnapshotTarget = nullptr;
+		return false;
+	}
+
+	// Detach before rendering so the widget renderer can host it in its own virtual window
+	Screen->RemoveFromParent();
+	TSharedRef<SWidget> ScreenWidget = Screen->TakeWidget();
+
+	FWidgetRenderer WidgetRenderer(true);
+	WidgetRenderer.DrawWidget(SnapshotTarget, ScreenWidget, ViewportScale, ViewportSize / ViewportScale, 0.0f);
+
+	CompositeMID->SetTextureParameterValue(SnapshotParameterName, SnapshotTarget);
+	CompositeMID->SetScalarParameterValue(ProgressParameterName, 0.0f);
+	CompositeMID->SetScalarParameterValue(ModeParameterName, static_cast<float>(TransitionType));
+	CompositeMID->SetVectorParameterValue(DirectionParameterName, GetDirectionVector());
+
+	CompositeBrush = FSlateBrush();
+	CompositeBrush.SetResourceObject(CompositeMID);
+	CompositeBrush.ImageSize = ViewportSize / ViewportScale;
+
+	CompositeOverlay = SNew(SImage)
+		.Image(&CompositeBrush)
+		.Visibility(EVisibility::HitTestInvisible);
+
+	ViewportClient->AddViewportWidgetContent(CompositeOverlay.ToSharedRef(), OverlayZOrder);
+	OverlayViewport = ViewportClient;
+
+	return true;
+}
+
+void UCompositeTransitionEffect::ReleaseSnapshot()
+{
+	if (CompositeOverlay.IsValid())
+	{
+		if (UGameViewportClient* ViewportClient = OverlayViewport.Get())
+		{
+			ViewportClient->RemoveViewportWidgetContent(CompositeOverlay.ToSharedRef());
+		}
+		CompositeOverlay.Reset();
+	}
+
+	OverlayViewport.Reset();
+	CompositeBrush.SetResourceObject(nullptr);
+	CompositeMID = nullptr;
+	SnapshotTarget = nullptr;
+}
+
+FLinearColor UCompositeTransitionEffect::GetDirectionVector() const
+{
+	switch (SlideDirection)
+	{
+	case EScreenTransitionSlideDirection::Left:
+		return FLinearColor(-1.0f, 0.0f, 0.0f, 0.0f);
+	case EScreenTransitionSlideDirection::Right:
+		return FLinearColor(1.0f, 0.0f, 0.0f, 0.0f);
+	case EScreenTransitionSlideDirection::Up:
+		return FLinearColor(0.0f, -1.0f, 0.0f, 0.0f);
+	case EScreenTransitionSlideDirection::Down:
+		return FLinearColor(0.0f, 1.0f, 0.0f, 0.0f);
+	}
+
+	return FLinearColor::Black;
+}
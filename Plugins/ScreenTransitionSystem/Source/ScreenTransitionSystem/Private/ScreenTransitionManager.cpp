@@ -1,7 +1,34 @@
 #include "ScreenTransitionManager.h"
+#include "ScreenTransitionStats.h"
 #include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
 #include "TimerManager.h"
 
+static void DumpScreenTransitionHistory(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	UScreenTransitionManager* Manager = GameInstance ? GameInstance->GetSubsystem<UScreenTransitionManager>() : nullptr;
+	if (!Manager)
+	{
+		Ar.Log(TEXT("ScreenTransitionManager is not available in this world"));
+		return;
+	}
+
+	Manager->DumpProfiling(Ar);
+
+	if (Args.Contains(TEXT("reset")))
+	{
+		Manager->ResetProfiling();
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpScreenTransitionHistoryCommand(
+	TEXT("ScreenTransition.DumpHistory"),
+	TEXT("Dumps per-screen-class creation, OnEnter/OnExit and transition timings. Pass 'reset' to clear the history afterwards."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&DumpScreenTransitionHistory)
+);
+
 void UScreenTransitionManager::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
@@ -10,6 +37,11 @@ void UScreenTransitionManager::Initialize(FSubsystemCollectionBase& Collection)
 	bIsTransitioning = false;
 	CurrentTransitionEffect = nullptr;
 	ScreenStack.Empty();
+
+	ScreenClassProfiles.Empty();
+	TotalDroppedRequests = 0;
+	TransitionStartTime = 0.0;
+	TransitionConfiguredDuration = 0.0f;
 }
 
 void UScreenTransitionManager::Deinitialize()
@@ -33,8 +65,14 @@ void UScreenTransitionManager::Deinitialize()
 
 void UScreenTransitionManager::TransitionToScreen(TSubclassOf<UScreenBase> ScreenClass, bool bUseTransition, TSubclassOf<UTransitionEffect> TransitionEffectClass)
 {
-	if (!ScreenClass || bIsTransitioning)
+	if (!ScreenClass)
+	{
+		return;
+	}
+
+	if (bIsTransitioning)
 	{
+		RecordDroppedRequest(ScreenClass);
 		return;
 	}
 
@@ -53,8 +91,14 @@ void UScreenTransitionManager::TransitionToScreen(TSubclassOf<UScreenBase> Scree
 
 void UScreenTransitionManager::PushScreen(TSubclassOf<UScreenBase> ScreenClass, bool bAsModal, bool bUseTransition, TSubclassOf<UTransitionEffect> TransitionEffectClass)
 {
-	if (!ScreenClass || bIsTransitioning)
+	if (!ScreenClass)
+	{
+		return;
+	}
+
+	if (bIsTransitioning)
 	{
+		RecordDroppedRequest(ScreenClass);
 		return;
 	}
 
@@ -76,17 +120,30 @@ void UScreenTransitionManager::PushScreen(TSubclassOf<UScreenBase> ScreenClass,
 
 bool UScreenTransitionManager::PopScreen(bool bUseTransition, TSubclassOf<UTransitionEffect> TransitionEffectClass)
 {
-	if (ScreenStack.Num() == 0 || bIsTransitioning)
+	if (ScreenStack.Num() == 0)
 	{
 		return false;
 	}
 
+	if (bIsTransitioning)
+	{
+		RecordDroppedRequest(ScreenStack.Last().Screen ? ScreenStack.Last().Screen->GetClass() : nullptr);
+		return false;
+	}
+
 	FScreenStackEntry LastEntry = ScreenStack.Last();
 	ScreenStack.RemoveAt(ScreenStack.Num() - 1);
 
 	UScreenBase* OldScreen = CurrentScreen;
 	UScreenBase* NewScreen = LastEntry.Screen;
 
+	if (NewScreen)
+	{
+		++GetProfile(NewScreen->GetClass()).ReuseCount;
+		INC_DWORD_STAT(STAT_ScreenTransition_ScreenReuses);
+		CSV_CUSTOM_STAT(ScreenTransition, ScreenReuses, 1, ECsvCustomStatOp::Accumulate);
+	}
+
 	PerformTransition(OldScreen, NewScreen, bUseTransition, TransitionEffectClass);
 
 	return true;
@@ -121,7 +178,7 @@ void UScreenTransitionManager::PerformTransition(UScreenBase* FromScreen, UScree
 
 	if (FromScreen)
 	{
-		FromScreen->OnExit();
+		ExitScreen(FromScreen);
 	}
 
 	if (bUseTransition)
@@ -134,14 +191,22 @@ void UScreenTransitionManager::PerformTransition(UScreenBase* FromScreen, UScree
 			if (CurrentTransitionEffect)
 			{
 				CurrentTransitionEffect->OnTransitionComplete.AddDynamic(this, &UScreenTransitionManager::OnTransitionEffectComplete);
-				CurrentTransitionEffect->StartTransition(FromScreen, ToScreen);
+
+				TransitionStartTime = FPlatformTime::Seconds();
+				TransitionConfiguredDuration = CurrentTransitionEffect->Duration;
+
+				{
+					SCOPE_CYCLE_COUNTER(STAT_ScreenTransition_EffectStart);
+					CSV_SCOPED_TIMING_STAT(ScreenTransition, EffectStart);
+					CurrentTransitionEffect->StartTransition(FromScreen, ToScreen);
+				}
 
 				CurrentScreen = ToScreen;
 				OnScreenChanged.Broadcast(FromScreen, ToScreen);
 
 				if (FromScreen && FromScreen != ToScreen)
 				{
-					DeactivateScreen(FromScreen);
+					RetireScreen(FromScreen);
 				}
 
 				return;
@@ -151,7 +216,7 @@ void UScreenTransitionManager::PerformTransition(UScreenBase* FromScreen, UScree
 
 	if (FromScreen && FromScreen != ToScreen)
 	{
-		DeactivateScreen(FromScreen);
+		RetireScreen(FromScreen);
 	}
 
 	CurrentScreen = ToScreen;
@@ -164,6 +229,20 @@ void UScreenTransitionManager::PerformTransition(UScreenBase* FromScreen, UScree
 
 void UScreenTransitionManager::OnTransitionEffectComplete()
 {
+	const float ElapsedMs = static_cast<float>((FPlatformTime::Seconds() - TransitionStartTime) * 1000.0);
+	const float ConfiguredMs = TransitionConfiguredDuration * 1000.0f;
+
+	CSV_CUSTOM_STAT(ScreenTransition, TransitionMs, ElapsedMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ScreenTransition, TransitionOverrunMs, ElapsedMs - ConfiguredMs, ECsvCustomStatOp::Set);
+
+	if (CurrentScreen)
+	{
+		FScreenClassProfile& Profile = GetProfile(CurrentScreen->GetClass());
+		++Profile.TransitionCount;
+		Profile.TotalTransitionMs += ElapsedMs;
+		Profile.TotalConfiguredMs += ConfiguredMs;
+	}
+
 	if (CurrentTransitionEffect)
 	{
 		CurrentTransitionEffect->OnTransitionComplete.RemoveDynamic(this, &UScreenTransitionManager::OnTransitionEffectComplete);
@@ -181,10 +260,39 @@ void UScreenTransitionManager::OnTransitionEffectComplete()
 
 void UScreenTransitionManager::ActivateScreen(UScreenBase* Screen)
 {
-	if (Screen)
+	if (!Screen)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
 	{
+		SCOPE_CYCLE_COUNTER(STAT_ScreenTransition_OnEnter);
+		CSV_SCOPED_TIMING_STAT(ScreenTransition, OnEnter);
 		Screen->OnEnter();
 	}
+	const float ElapsedMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	FScreenClassProfile& Profile = GetProfile(Screen->GetClass());
+	++Profile.EnterCount;
+	Profile.TotalEnterMs += ElapsedMs;
+	Profile.MaxEnterMs = FMath::Max(Profile.MaxEnterMs, ElapsedMs);
+}
+
+void UScreenTransitionManager::ExitScreen(UScreenBase* Screen)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ScreenTransition_OnExit);
+		CSV_SCOPED_TIMING_STAT(ScreenTransition, OnExit);
+		Screen->OnExit();
+	}
+	const float ElapsedMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	FScreenClassProfile& Profile = GetProfile(Screen->GetClass());
+	++Profile.ExitCount;
+	Profile.TotalExitMs += ElapsedMs;
+	Profile.MaxExitMs = FMath::Max(Profile.MaxExitMs, ElapsedMs);
 }
 
 void UScreenTransitionManager::DeactivateScreen(UScreenBase* Screen)
@@ -196,6 +304,24 @@ void UScreenTransitionManager::DeactivateScreen(UScreenBase* Screen)
 	}
 }
 
+void UScreenTransitionManager::RetireScreen(UScreenBase* Screen)
+{
+	// Screens that are still on the stack are only hidden so PopScreen can show them again
+	const bool bIsStacked = ScreenStack.ContainsByPredicate([Screen](const FScreenStackEntry& Entry)
+	{
+		return Entry.Screen == Screen;
+	});
+
+	if (bIsStacked)
+	{
+		Screen->RemoveFromParent();
+	}
+	else
+	{
+		DeactivateScreen(Screen);
+	}
+}
+
 UScreenBase* UScreenTransitionManager::CreateScreen(TSubclassOf<UScreenBase> ScreenClass)
 {
 	if (!ScreenClass)
@@ -215,6 +341,70 @@ UScreenBase* UScreenTransitionManager::CreateScreen(TSubclassOf<UScreenBase> Scr
 		return nullptr;
 	}
 
-	UScreenBase* NewScreen = CreateWidget<UScreenBase>(PC, ScreenClass);
+	const double StartTime = FPlatformTime::Seconds();
+	UScreenBase* NewScreen = nullptr;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ScreenTransition_CreateScreen);
+		CSV_SCOPED_TIMING_STAT(ScreenTransition, CreateScreen);
+		NewScreen = CreateWidget<UScreenBase>(PC, ScreenClass);
+	}
+	const float ElapsedMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	FScreenClassProfile& Profile = GetProfile(ScreenClass);
+	++Profile.CreateCount;
+	Profile.TotalCreateMs += ElapsedMs;
+	Profile.MaxCreateMs = FMath::Max(Profile.MaxCreateMs, ElapsedMs);
+
 	return NewScreen;
 }
+
+void UScreenTransitionManager::RecordDroppedRequest(UClass* ScreenClass)
+{
+	++TotalDroppedRequests;
+	INC_DWORD_STAT(STAT_ScreenTransition_DroppedRequests);
+	CSV_CUSTOM_STAT(ScreenTransition, DroppedRequests, 1, ECsvCustomStatOp::Accumulate);
+
+	if (ScreenClass)
+	{
+		++GetProfile(ScreenClass).DroppedRequests;
+	}
+}
+
+FScreenClassProfile& UScreenTransitionManager::GetProfile(UClass* ScreenClass)
+{
+	return ScreenClassProfiles.FindOrAdd(ScreenClass);
+}
+
+FScreenClassProfile UScreenTransitionManager::GetScreenClassProfile(TSubclassOf<UScreenBase> ScreenClass) const
+{
+	const FScreenClassProfile* Profile = ScreenClassProfiles.Find(ScreenClass.Get());
+	return Profile ? *Profile : FScreenClassProfile();
+}
+
+void UScreenTransitionManager::ResetProfiling()
+{
+	ScreenClassProfiles.Empty();
+	TotalDroppedRequests = 0;
+}
+
+void UScreenTransitionManager::DumpProfiling(FOutputDevice& Ar) const
+{
+	auto Average = [](float Total, int32 Count)
+	{
+		return Count > 0 ? Total / Count : 0.0f;
+	};
+
+	Ar.Logf(TEXT("Screen transition history (%d classes, %d dropped requests)"), ScreenClassProfiles.Num(), TotalDroppedRequests);
+
+	for (const TPair<TObjectPtr<UClass>, FScreenClassProfile>& Pair : ScreenClassProfiles)
+	{
+		const FScreenClassProfile& Profile = Pair.Value;
+
+		Ar.Logf(TEXT("  %s"), *GetNameSafe(Pair.Key));
+		Ar.Logf(TEXT("    Create:     %4d x  avg %7.3f ms  max %7.3f ms"), Profile.CreateCount, Average(Profile.TotalCreateMs, Profile.CreateCount), Profile.MaxCreateMs);
+		Ar.Logf(TEXT("    OnEnter:    %4d x  avg %7.3f ms  max %7.3f ms"), Profile.EnterCount, Average(Profile.TotalEnterMs, Profile.EnterCount), Profile.MaxEnterMs);
+		Ar.Logf(TEXT("    OnExit:     %4d x  avg %7.3f ms  max %7.3f ms"), Profile.ExitCount, Average(Profile.TotalExitMs, Profile.ExitCount), Profile.MaxExitMs);
+		Ar.Logf(TEXT("    Transition: %4d x  avg %7.3f ms  (configured %7.3f ms)"), Profile.TransitionCount, Average(Profile.TotalTransitionMs, Profile.TransitionCount), Average(Profile.TotalConfiguredMs, Profile.TransitionCount));
+		Ar.Logf(TEXT("    Reused:     %4d    Dropped: %d"), Profile.ReuseCount, Profile.DroppedRequests);
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_STATS_GROUP(TEXT("ScreenTransition"), STATGROUP_ScreenTransition, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Screen"), STAT_ScreenTransition_CreateScreen, STATGROUP_ScreenTransition, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Screen OnEnter"), STAT_ScreenTransition_OnEnter, STATGROUP_ScreenTransition, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Screen OnExit"), STAT_ScreenTransition_OnExit, STATGROUP_ScreenTransition, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Effect Start"), STAT_ScreenTransition_EffectStart, STATGROUP_ScreenTransition, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Effect Tick"), STAT_ScreenTransition_EffectTick, STATGROUP_ScreenTransition, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Dropped Requests"), STAT_ScreenTransition_DroppedRequests, STATGROUP_ScreenTransition, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Screen Reuses"), STAT_ScreenTransition_ScreenReuses, STATGROUP_ScreenTransition, );
+
+CSV_DECLARE_CATEGORY_EXTERN(ScreenTransition);
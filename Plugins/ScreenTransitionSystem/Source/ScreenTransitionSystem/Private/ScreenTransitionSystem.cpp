@@ -1,7 +1,18 @@
 #include "ScreenTransitionSystem.h"
+#include "ScreenTransitionStats.h"
 
 #define LOCTEXT_NAMESPACE "FScreenTransitionSystemModule"
 
+DEFINE_STAT(STAT_ScreenTransition_CreateScreen);
+DEFINE_STAT(STAT_ScreenTransition_OnEnter);
+DEFINE_STAT(STAT_ScreenTransition_OnExit);
+DEFINE_STAT(STAT_ScreenTransition_EffectStart);
+DEFINE_STAT(STAT_ScreenTransition_EffectTick);
+DEFINE_STAT(STAT_ScreenTransition_DroppedRequests);
+DEFINE_STAT(STAT_ScreenTransition_ScreenReuses);
+
+CSV_DEFINE_CATEGORY(ScreenTransition, true);
+
 void FScreenTransitionSystemModule::StartupModule()
 {
 }
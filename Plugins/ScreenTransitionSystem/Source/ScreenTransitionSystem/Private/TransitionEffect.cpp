@@ -1,9 +1,10 @@
 #include "TransitionEffect.h"
 #include "ScreenBase.h"
-#include "Components/CanvasPanelSlot.h"
+#include "ScreenTransitionStats.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
 
 UTransitionEffect::UTransitionEffect()
 {
@@ -57,6 +58,9 @@ void UTransitionEffect::OnTransitionTick()
 		return;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_ScreenTransition_EffectTick);
+	CSV_SCOPED_TIMING_STAT(ScreenTransition, EffectTick);
+
 	CurrentTime += 0.016f;
 	float Alpha = FMath::Clamp(CurrentTime / Duration, 0.0f, 1.0f);
 
@@ -75,6 +79,9 @@ void UTransitionEffect::UpdateTransition(float DeltaTime)
 		return;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_ScreenTransition_EffectTick);
+	CSV_SCOPED_TIMING_STAT(ScreenTransition, EffectTick);
+
 	CurrentTime += DeltaTime;
 	float Alpha = FMath::Clamp(CurrentTime / Duration, 0.0f, 1.0f);
 
@@ -93,7 +100,9 @@ void UTransitionEffect::TickTransition_Implementation(float Alpha)
 	switch (TransitionType)
 	{
 	case EScreenTransitionType::Fade:
+	case EScreenTransitionType::Wipe:
 	{
+		// Wipe needs a masked composite (see UCompositeTransitionEffect), so the per-widget path plays it as a fade
 		if (FromScreenRef)
 		{
 			FromScreenRef->SetRenderOpacity(1.0f - EasedAlpha);
@@ -106,32 +115,31 @@ void UTransitionEffect::TickTransition_Implementation(float Alpha)
 	}
 	case EScreenTransitionType::Slide:
 	{
-		if (ToScreenRef && ToScreenRef->Slot)
+		if (ToScreenRef)
 		{
-			UCanvasPanelSlot* CanvasSlot = Cast<UCanvasPanelSlot>(ToScreenRef->Slot);
-			if (CanvasSlot)
+			// Render translation only affects paint, so sliding does not invalidate the screen's layout.
+			// The screen's own geometry is still zero on the first tick after AddToViewport, so slide by the viewport size instead
+			const float ViewportScale = UWidgetLayoutLibrary::GetViewportScale(ToScreenRef);
+			const FVector2D ScreenSize = ViewportScale > 0.0f ? UWidgetLayoutLibrary::GetViewportSize(ToScreenRef) / ViewportScale : FVector2D::ZeroVector;
+			FVector2D Offset = FVector2D::ZeroVector;
+
+			switch (SlideDirection)
 			{
-				FVector2D ScreenSize = CanvasSlot->GetSize();
-				FVector2D Offset = FVector2D::ZeroVector;
-
-				switch (SlideDirection)
-				{
-				case EScreenTransitionSlideDirection::Left:
-					Offset.X = ScreenSize.X * (1.0f - EasedAlpha);
-					break;
-				case EScreenTransitionSlideDirection::Right:
-					Offset.X = -ScreenSize.X * (1.0f - EasedAlpha);
-					break;
-				case EScreenTransitionSlideDirection::Up:
-					Offset.Y = ScreenSize.Y * (1.0f - EasedAlpha);
-					break;
-				case EScreenTransitionSlideDirection::Down:
-					Offset.Y = -ScreenSize.Y * (1.0f - EasedAlpha);
-					break;
-				}
-
-				CanvasSlot->SetPosition(Offset);
+			case EScreenTransitionSlideDirection::Left:
+				Offset.X = ScreenSize.X * (1.0f - EasedAlpha);
+				break;
+			case EScreenTransitionSlideDirection::Right:
+				Offset.X = -ScreenSize.X * (1.0f - EasedAlpha);
+				break;
+			case EScreenTransitionSlideDirection::Up:
+				Offset.Y = ScreenSize.Y * (1.0f - EasedAlpha);
+				break;
+			case EScreenTransitionSlideDirection::Down:
+				Offset.Y = -ScreenSize.Y * (1.0f - EasedAlpha);
+				break;
 			}
+
+			ToScreenRef->SetRenderTranslation(Offset);
 		}
 		break;
 	}
@@ -150,6 +158,13 @@ void UTransitionEffect::CompleteTransition()
 		World->GetTimerManager().ClearTimer(TransitionTimerHandle);
 	}
 
+	ResetScreens();
+
+	OnTransitionComplete.Broadcast();
+}
+
+void UTransitionEffect::ResetScreens()
+{
 	if (FromScreenRef)
 	{
 		FromScreenRef->SetRenderOpacity(1.0f);
@@ -158,15 +173,6 @@ void UTransitionEffect::CompleteTransition()
 	if (ToScreenRef)
 	{
 		ToScreenRef->SetRenderOpacity(1.0f);
-		if (ToScreenRef->Slot)
-		{
-			UCanvasPanelSlot* CanvasSlot = Cast<UCanvasPanelSlot>(ToScreenRef->Slot);
-			if (CanvasSlot)
-			{
-				CanvasSlot->SetPosition(FVector2D::ZeroVector);
-			}
-		}
+		ToScreenRef->SetRenderTranslation(FVector2D::ZeroVector);
 	}
-
-	OnTransitionComplete.Broadcast();
 }
@@ -32,6 +32,57 @@ struct FScreenStackEntry
 	{}
 };
 
+USTRUCT(BlueprintType)
+struct FScreenClassProfile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	int32 CreateCount = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	float TotalCreateMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	float MaxCreateMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	int32 EnterCount = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	float TotalEnterMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	float MaxEnterMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	int32 ExitCount = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	float TotalExitMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	float MaxExitMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	int32 TransitionCount = 0;
+
+	/** Wall-clock time from effect start to completion */
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	float TotalTransitionMs = 0.0f;
+
+	/** Sum of the effects' configured Duration, for comparison with TotalTransitionMs */
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	float TotalConfiguredMs = 0.0f;
+
+	/** Times an existing instance was shown again instead of creating a new widget */
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	int32 ReuseCount = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Screen Transition|Profiling")
+	int32 DroppedRequests = 0;
+};
+
 UCLASS()
 class SCREENTRANSITIONSYSTEM_API UScreenTransitionManager : public UGameInstanceSubsystem
 {
@@ -74,6 +125,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Screen Transition")
 	void SetDefaultTransitionEffect(TSubclassOf<UTransitionEffect> TransitionEffectClass);
 
+	UFUNCTION(BlueprintPure, Category = "Screen Transition|Profiling")
+	FScreenClassProfile GetScreenClassProfile(TSubclassOf<UScreenBase> ScreenClass) const;
+
+	UFUNCTION(BlueprintPure, Category = "Screen Transition|Profiling")
+	int32 GetDroppedRequestCount() const { return TotalDroppedRequests; }
+
+	UFUNCTION(BlueprintCallable, Category = "Screen Transition|Profiling")
+	void ResetProfiling();
+
+	void DumpProfiling(FOutputDevice& Ar) const;
+
 protected:
 	UPROPERTY()
 	UScreenBase* CurrentScreen;
@@ -90,10 +152,21 @@ protected:
 	UPROPERTY()
 	UTransitionEffect* CurrentTransitionEffect;
 
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FScreenClassProfile> ScreenClassProfiles;
+
+	int32 TotalDroppedRequests;
+	double TransitionStartTime;
+	float TransitionConfiguredDuration;
+
 private:
 	void PerformTransition(UScreenBase* FromScreen, UScreenBase* ToScreen, bool bUseTransition, TSubclassOf<UTransitionEffect> TransitionEffectClass);
 	void OnTransitionEffectComplete();
 	void ActivateScreen(UScreenBase* Screen);
 	void DeactivateScreen(UScreenBase* Screen);
+	void RetireScreen(UScreenBase* Screen);
 	UScreenBase* CreateScreen(TSubclassOf<UScreenBase> ScreenClass);
+	void ExitScreen(UScreenBase* Screen);
+	void RecordDroppedRequest(UClass* ScreenClass);
+	FScreenClassProfile& GetProfile(UClass* ScreenClass);
 };
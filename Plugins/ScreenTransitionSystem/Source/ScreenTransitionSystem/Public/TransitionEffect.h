@@ -13,6 +13,8 @@ enum class EScreenTransitionType : uint8
 {
 	Fade UMETA(DisplayName = "Fade"),
 	Slide UMETA(DisplayName = "Slide"),
+	// Only UCompositeTransitionEffect draws a real wipe, a plain UTransitionEffect plays it as a fade
+	Wipe UMETA(DisplayName = "Wipe", ToolTip = "Wipe between screens. Requires a Composite Transition Effect, otherwise it plays as a fade."),
 	Custom UMETA(DisplayName = "Custom")
 };
 
@@ -72,6 +74,8 @@ protected:
 	void TickTransition(float Alpha);
 	virtual void TickTransition_Implementation(float Alpha);
 
+	virtual void ResetScreens();
+
 private:
 	FTimerHandle TransitionTimerHandle;
 	void OnTransitionTick();
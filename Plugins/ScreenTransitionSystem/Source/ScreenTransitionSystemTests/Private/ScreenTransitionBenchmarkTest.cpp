@@ -0,0 +1,230 @@
+#include "ScreenTransitionBenchmarkTest.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "ScreenTransitionManager.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectIterator.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static TAutoConsoleVariable<int32> CVarScreenTransitionBenchmarkIterations(
+	TEXT("ScreenTransition.Benchmark.Iterations"),
+	5000,
+	TEXT("Number of push/pop/transition operations per phase of the ScreenTransitionSystem benchmark."));
+
+namespace ScreenTransitionBenchmark
+{
+	/** Counts UObject creations and deletions while registered with GUObjectArray */
+	class FObjectChurnCounter : public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
+	{
+	public:
+		FObjectChurnCounter()
+		{
+			GUObjectArray.AddUObjectCreateListener(this);
+			GUObjectArray.AddUObjectDeleteListener(this);
+		}
+
+		virtual ~FObjectChurnCounter()
+		{
+			GUObjectArray.RemoveUObjectCreateListener(this);
+			GUObjectArray.RemoveUObjectDeleteListener(this);
+		}
+
+		virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override
+		{
+			++Created;
+		}
+
+		virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override
+		{
+			++Deleted;
+		}
+
+		virtual void OnUObjectArrayShutdown() override
+		{
+			GUObjectArray.RemoveUObjectCreateListener(this);
+			GUObjectArray.RemoveUObjectDeleteListener(this);
+		}
+
+		void Reset()
+		{
+			Created = 0;
+			Deleted = 0;
+		}
+
+		int64 Created = 0;
+		int64 Deleted = 0;
+	};
+
+	struct FPhaseResult
+	{
+		int32 Operations = 0;
+		double Seconds = 0.0;
+		int64 ObjectsCreated = 0;
+		int64 ObjectsCollected = 0;
+	};
+
+	static int32 CountLiveBenchmarkScreens()
+	{
+		int32 Count = 0;
+		for (TObjectIterator<UScreenBase> It; It; ++It)
+		{
+			const UScreenBase* Screen = *It;
+			if (Screen->HasAnyFlags(RF_ClassDefaultObject) || !IsValid(Screen))
+			{
+				continue;
+			}
+
+			const UClass* Class = Screen->GetClass();
+			if (Class == UBenchmarkScreenA::StaticClass() || Class == UBenchmarkScreenB::StaticClass()
+				|| Class == UBenchmarkScreenC::StaticClass() || Class == UBenchmarkScreenD::StaticClass())
+			{
+				++Count;
+			}
+		}
+		return Count;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FScreenTransitionBenchmarkTest, "ScreenTransitionSystem.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FScreenTransitionBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace ScreenTransitionBenchmark;
+
+	const int32 Iterations = FMath::Max(1, CVarScreenTransitionBenchmarkIterations.GetValueOnGameThread());
+	const TSubclassOf<UScreenBase> ScreenClasses[] =
+	{
+		UBenchmarkScreenA::StaticClass(),
+		UBenchmarkScreenB::StaticClass(),
+		UBenchmarkScreenC::StaticClass(),
+		UBenchmarkScreenD::StaticClass()
+	};
+	const int32 NumScreenClasses = UE_ARRAY_COUNT(ScreenClasses);
+
+	// A standalone game instance owns its own world and brings the subsystem up without a viewport
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone();
+
+	UWorld* World = GameInstance->GetWorld();
+	if (!World)
+	{
+		AddError(TEXT("Failed to create standalone World"));
+		GameInstance->RemoveFromRoot();
+		return false;
+	}
+
+	World->SpawnActor<APlayerController>();
+
+	UScreenTransitionManager* Manager = GameInstance->GetSubsystem<UScreenTransitionManager>();
+	if (!Manager)
+	{
+		AddError(TEXT("ScreenTransitionManager subsystem was not created"));
+		GameInstance->Shutdown();
+		GameInstance->RemoveFromRoot();
+		return false;
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const int32 BaselineScreens = CountLiveBenchmarkScreens();
+
+	FObjectChurnCounter Churn;
+
+	auto RunPhase = [&](const TCHAR* Name, int32 Operations, TFunctionRef<void(int32)> Body)
+	{
+		FPhaseResult Result;
+		Result.Operations = Operations;
+
+		Churn.Reset();
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Operations; ++Index)
+		{
+			Body(Index);
+		}
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+		Result.ObjectsCreated = Churn.Created;
+
+		// Anything the phase left unreferenced should be reclaimed by a single full collection
+		Churn.Reset();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		Result.ObjectsCollected = Churn.Deleted;
+
+		const double OpsPerSecond = Result.Seconds > 0.0 ? Result.Operations / Result.Seconds : 0.0;
+		const double AllocsPerOp = static_cast<double>(Result.ObjectsCreated) / Result.Operations;
+		const FString Summary = FString::Printf(TEXT("%s: %d ops in %.2f ms (%.0f ops/s), %.2f UObject allocs/op, %lld objects collected by GC"),
+			Name, Result.Operations, Result.Seconds * 1000.0, OpsPerSecond, AllocsPerOp, Result.ObjectsCollected);
+
+		AddInfo(Summary);
+		UE_LOG(LogTemp, Display, TEXT("[ScreenTransitionBenchmark] %s"), *Summary);
+
+		return Result;
+	};
+
+	// Push a full stack of distinct screens, then pop back down to the root
+	RunPhase(TEXT("PushPop"), Iterations, [&](int32 Index)
+	{
+		if (Index % (NumScreenClasses * 2) < NumScreenClasses)
+		{
+			Manager->PushScreen(ScreenClasses[Index % NumScreenClasses], false, false);
+		}
+		else
+		{
+			Manager->PopScreen(false);
+		}
+	});
+
+	Manager->ClearScreenStack();
+
+	RunPhase(TEXT("TransitionTo"), Iterations, [&](int32 Index)
+	{
+		Manager->TransitionToScreen(ScreenClasses[Index % NumScreenClasses], false);
+	});
+
+	// The effect path is driven by the world timer manager, so step it by hand until each transition completes
+	const int32 EffectIterations = FMath::Max(1, Iterations / 10);
+	int32 StalledTransitions = 0;
+	RunPhase(TEXT("TransitionToWithEffect"), EffectIterations, [&](int32 Index)
+	{
+		Manager->TransitionToScreen(ScreenClasses[Index % NumScreenClasses], true, UBenchmarkTransitionEffect::StaticClass());
+
+		for (int32 Step = 0; Step < 100 && Manager->IsTransitioning(); ++Step)
+		{
+			World->GetTimerManager().Tick(0.016f);
+		}
+
+		if (Manager->IsTransitioning())
+		{
+			++StalledTransitions;
+		}
+	});
+
+	TestEqual(TEXT("All effect transitions completed"), StalledTransitions, 0);
+
+	// After clearing, only the current screen may still hold a widget
+	Manager->ClearScreenStack();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	const int32 ExpectedScreens = BaselineScreens + (Manager->GetCurrentScreen() ? 1 : 0);
+	const int32 LiveScreens = CountLiveBenchmarkScreens();
+	TestEqual(TEXT("Leaked screen widgets after ClearScreenStack"), LiveScreens - ExpectedScreens, 0);
+
+	TestEqual(TEXT("No requests were dropped"), Manager->GetDroppedRequestCount(), 0);
+
+	GameInstance->Shutdown();
+	GameInstance->RemoveFromRoot();
+	if (GEngine)
+	{
+		GEngine->DestroyWorldContext(World);
+	}
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif
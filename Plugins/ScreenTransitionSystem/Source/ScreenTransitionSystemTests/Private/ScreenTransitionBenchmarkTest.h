@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScreenBase.h"
+#include "TransitionEffect.h"
+#include "ScreenTransitionBenchmarkTest.generated.h"
+
+/**
+ * Synthetic screens used by the ScreenTransitionSystem benchmark automation test.
+ * Several distinct classes are needed so per-class bookkeeping is exercised.
+ * They live in the uncooked-only test module so they never ship or show up in class pickers.
+ */
+UCLASS(Hidden, HideDropdown, NotBlueprintable)
+class UBenchmarkScreenA : public UScreenBase
+{
+	GENERATED_BODY()
+
+public:
+	UBenchmarkScreenA(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer) {}
+};
+
+UCLASS(Hidden, HideDropdown, NotBlueprintable)
+class UBenchmarkScreenB : public UScreenBase
+{
+	GENERATED_BODY()
+
+public:
+	UBenchmarkScreenB(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer) {}
+};
+
+UCLASS(Hidden, HideDropdown, NotBlueprintable)
+class UBenchmarkScreenC : public UScreenBase
+{
+	GENERATED_BODY()
+
+public:
+	UBenchmarkScreenC(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer) {}
+};
+
+UCLASS(Hidden, HideDropdown, NotBlueprintable)
+class UBenchmarkScreenD : public UScreenBase
+{
+	GENERATED_BODY()
+
+public:
+	UBenchmarkScreenD(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer) {}
+};
+
+/** Short fade so the effect path can be stepped through quickly with a manual timer tick */
+UCLASS(Hidden, HideDropdown, NotBlueprintable)
+class UBenchmarkTransitionEffect : public UTransitionEffect
+{
+	GENERATED_BODY()
+
+public:
+	UBenchmarkTransitionEffect()
+	{
+		TransitionType = EScreenTransitionType::Fade;
+		Duration = 0.05f;
+	}
+};
@@ -0,0 +1,20 @@
+using UnrealBuildTool;
+
+public class ScreenTransitionSystemTests : ModuleRules
+{
+	public ScreenTransitionSystemTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"UMG",
+				"ScreenTransitionSystem"
+			}
+		);
+	}
+}
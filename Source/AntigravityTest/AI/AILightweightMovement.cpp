@@ -0,0 +1,462 @@
+#include "AI/AILightweightMovement.h"
+#include "AIController.h"
+#include "Async/ParallelFor.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI Lightweight Movers"), STAT_AILightweightMovers, STATGROUP_Game);
+
+static TAutoConsoleVariable<bool> CVarAILightweightMovementEnabled(
+	TEXT("AI.LightweightMovement.Enabled"),
+	false,
+	TEXT("If true, AIs in significance buckets that allow it are moved by the batched lightweight movement pass instead of their character movement component."));
+
+static TAutoConsoleVariable<int32> CVarAILightweightMovementBatchSize(
+	TEXT("AI.LightweightMovement.BatchSize"),
+	32,
+	TEXT("Number of agents integrated per worker batch."));
+
+static TAutoConsoleVariable<bool> CVarAILightweightMovementParallel(
+	TEXT("AI.LightweightMovement.Parallel"),
+	true,
+	TEXT("If true, lightweight movement batches run on worker threads. Otherwise they run on the game thread."));
+
+// How far below an agent walking off the navmesh we look for ground to fall to
+static constexpr float LightweightFallProbeDistance = 1000.0f;
+
+UAILightweightMovement* UAILightweightMovement::Get(const UWorld* World)
+{
+	if (!World || !CVarAILightweightMovementEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UAILightweightMovement>();
+}
+
+void UAILightweightMovement::Deinitialize()
+{
+	for (FAgent& Agent : Agents)
+	{
+		StopLightweight(Agent);
+	}
+
+	Agents.Empty();
+	AgentIndices.Empty();
+	MoveStates.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UAILightweightMovement::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UAILightweightMovement::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAILightweightMovement, STATGROUP_Tickables);
+}
+
+void UAILightweightMovement::AddAgent(ACharacter* Character)
+{
+	if (!IsValid(Character) || !Character->GetCharacterMovement() || AgentIndices.Contains(Character))
+	{
+		return;
+	}
+
+	FAgent& NewAgent = Agents.AddDefaulted_GetRef();
+	NewAgent.Key = Character;
+	NewAgent.Character = Character;
+	NewAgent.Movement = Character->GetCharacterMovement();
+	NewAgent.Controller = Cast<AAIController>(Character->GetController());
+
+	AgentIndices.Add(Character, Agents.Num() - 1);
+
+	// The agent switches over on the next pass, once we know it's walking
+}
+
+void UAILightweightMovement::RemoveAgent(ACharacter* Character)
+{
+	if (const int32* AgentIndex = AgentIndices.Find(Character))
+	{
+		StopLightweight(Agents[*AgentIndex]);
+		RemoveAgentAt(*AgentIndex);
+	}
+}
+
+bool UAILightweightMovement::IsMovingLightweight(const ACharacter* Character) const
+{
+	const int32* AgentIndex = AgentIndices.Find(Character);
+	return AgentIndex && Agents[*AgentIndex].bLightweight;
+}
+
+void UAILightweightMovement::RemoveAgentAt(int32 AgentIndex)
+{
+	AgentIndices.Remove(Agents[AgentIndex].Key);
+
+	// The last agent moves into the freed slot
+	const int32 LastIndex = Agents.Num() - 1;
+	if (AgentIndex != LastIndex)
+	{
+		AgentIndices.Add(Agents[LastIndex].Key, AgentIndex);
+	}
+	Agents.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+}
+
+void UAILightweightMovement::StartLightweight(FAgent& Agent)
+{
+	UCharacterMovementComponent* Movement = Agent.Movement.Get();
+	if (Agent.bLightweight || !Movement)
+	{
+		return;
+	}
+
+	// We move the character from now on
+	Movement->SetComponentTickEnabled(false);
+
+	Agent.bLightweight = true;
+	Agent.bFalling = false;
+}
+
+void UAILightweightMovement::StopLightweight(FAgent& Agent)
+{
+	if (!Agent.bLightweight)
+	{
+		return;
+	}
+
+	Agent.bLightweight = false;
+	Agent.bFalling = false;
+
+	// The movement component picks up from the velocity and movement mode we left it
+	if (UCharacterMovementComponent* Movement = Agent.Movement.Get())
+	{
+		Movement->SetComponentTickEnabled(true);
+	}
+}
+
+bool UAILightweightMovement::NeedsFullMovement(const ACharacter& Character, const UCharacterMovementComponent& Movement, bool bFalling) const
+{
+	// Movement was disabled, e.g. the character died or went back to its pool
+	if (Movement.MovementMode == MOVE_None)
+	{
+		return true;
+	}
+
+	// Jumps, launches and root motion are only handled by the full component
+	if (Character.bPressedJump || !Movement.PendingLaunchVelocity.IsZero() || Character.IsPlayingRootMotion())
+	{
+		return true;
+	}
+
+	// So is a ragdoll or a hit reaction pulling on the mesh
+	if (const USkeletalMeshComponent* Mesh = Character.GetMesh())
+	{
+		if (Mesh->IsSimulatingPhysics())
+		{
+			return true;
+		}
+	}
+
+	// While the full component runs, only switch over once it's walking
+	return !bFalling && !Movement.IsMovingOnGround();
+}
+
+void UAILightweightMovement::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_AILightweightMovers, 0);
+
+	if (Agents.IsEmpty())
+	{
+		return;
+	}
+
+	// Hand everyone back once when lightweight movement gets disabled, or when there is no navmesh to move on
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	NavData = NavSys ? NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+
+	if (!CVarAILightweightMovementEnabled.GetValueOnGameThread() || !NavData || DeltaTime <= 0.0f)
+	{
+		for (FAgent& Agent : Agents)
+		{
+			StopLightweight(Agent);
+		}
+
+		NavData = nullptr;
+		return;
+	}
+
+	NavFilter = NavData->GetDefaultQueryFilter();
+
+	// Drop agents that went away without unregistering
+	for (int32 AgentIndex = Agents.Num() - 1; AgentIndex >= 0; --AgentIndex)
+	{
+		if (!Agents[AgentIndex].Character.IsValid() || !Agents[AgentIndex].Movement.IsValid())
+		{
+			RemoveAgentAt(AgentIndex);
+		}
+	}
+
+	// Switch agents between paths and gather the inputs of the lightweight ones
+	MoveStates.Reset();
+
+	for (int32 AgentIndex = 0; AgentIndex < Agents.Num(); ++AgentIndex)
+	{
+		FAgent& Agent = Agents[AgentIndex];
+		ACharacter* Character = Agent.Character.Get();
+		UCharacterMovementComponent* Movement = Agent.Movement.Get();
+
+		const bool bNeedsFullMovement = NeedsFullMovement(*Character, *Movement, Agent.bLightweight && Agent.bFalling);
+		if (bNeedsFullMovement)
+		{
+			StopLightweight(Agent);
+			continue;
+		}
+
+		StartLightweight(Agent);
+
+		// Placed pawns may have been possessed after they registered
+		AAIController* Controller = Agent.Controller.Get();
+		if (!Controller)
+		{
+			Controller = Cast<AAIController>(Character->GetController());
+			Agent.Controller = Controller;
+		}
+
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+
+		FMoveState& State = MoveStates.AddDefaulted_GetRef();
+		State.AgentIndex = AgentIndex;
+		State.Radius = Capsule->GetScaledCapsuleRadius();
+		State.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+		State.FeetLocation = Character->GetActorLocation() - FVector(0.0f, 0.0f, State.HalfHeight);
+		State.Velocity = Movement->Velocity;
+		State.Yaw = Character->GetActorRotation().Yaw;
+		State.bFalling = Agent.bFalling;
+		State.FallFloorZ = Agent.FallFloorZ;
+
+		State.MaxAcceleration = Movement->GetMaxAcceleration();
+		State.BrakingDeceleration = Movement->GetMaxBrakingDeceleration();
+		State.GravityZ = Movement->GetGravityZ();
+		State.StepHeight = Movement->MaxStepHeight;
+		State.YawRate = Movement->RotationRate.Yaw;
+		State.bOrientToMovement = Movement->bOrientRotationToMovement;
+
+		// Path following keeps steering the agent; it just can't hand its requests to the switched off component
+		FVector Direction = FVector::ZeroVector;
+		if (Controller)
+		{
+			const UPathFollowingComponent* PathFollowing = Controller->GetPathFollowingComponent();
+			if (PathFollowing && PathFollowing->GetStatus() == EPathFollowingStatus::Moving)
+			{
+				Direction = PathFollowing->GetCurrentDirection();
+			}
+
+			if (Movement->bUseControllerDesiredRotation)
+			{
+				State.bHasDesiredYaw = true;
+				State.DesiredYaw = Controller->GetDesiredRotation().Yaw;
+			}
+		}
+
+		// Also honor movement input added by StateTree tasks
+		Direction += Movement->ConsumeInputVector();
+		Direction.Z = 0.0f;
+
+		State.DesiredVelocity = Direction.GetClampedToMaxSize(1.0f) * Movement->GetMaxSpeed();
+	}
+
+	SET_DWORD_STAT(STAT_AILightweightMovers, MoveStates.Num());
+
+	if (MoveStates.IsEmpty())
+	{
+		NavData = nullptr;
+		NavFilter.Reset();
+		return;
+	}
+
+	// Integrate in batches on worker threads
+	const int32 BatchSize = FMath::Max(1, CVarAILightweightMovementBatchSize.GetValueOnGameThread());
+	const int32 NumBatches = FMath::DivideAndRoundUp(MoveStates.Num(), BatchSize);
+
+	ParallelFor(NumBatches, [this, BatchSize, DeltaTime](int32 BatchIndex)
+	{
+		const int32 FirstState = BatchIndex * BatchSize;
+		IntegrateMoveStates(FirstState, FMath::Min(BatchSize, MoveStates.Num() - FirstState), DeltaTime);
+	}, CVarAILightweightMovementParallel.GetValueOnGameThread() ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	// Write the results back in one pass
+	for (const FMoveState& State : MoveStates)
+	{
+		FAgent& Agent = Agents[State.AgentIndex];
+		ACharacter* Character = Agent.Character.Get();
+		UCharacterMovementComponent* Movement = Agent.Movement.Get();
+
+		Character->SetActorLocationAndRotation(State.FeetLocation + FVector(0.0f, 0.0f, State.HalfHeight), FRotator(0.0f, State.Yaw, 0.0f));
+
+		// Animation reads speed and falling state from the movement component
+		Movement->Velocity = State.Velocity;
+		Movement->UpdateComponentVelocity();
+
+		Agent.bFalling = State.bFalling;
+		Agent.FallFloorZ = State.FallFloorZ;
+
+		if (State.bStartedFalling)
+		{
+			Movement->SetMovementMode(MOVE_Falling);
+		}
+		else if (State.bLanded)
+		{
+			Movement->SetMovementMode(MOVE_Walking);
+
+			FHitResult Hit;
+			Hit.bBlockingHit = true;
+			Hit.Location = Hit.ImpactPoint = State.FeetLocation;
+			Hit.Normal = Hit.ImpactNormal = FVector::UpVector;
+			Character->Landed(Hit);
+		}
+
+		if (State.bLostGround)
+		{
+			StopLightweight(Agent);
+		}
+	}
+
+	NavData = nullptr;
+	NavFilter.Reset();
+}
+
+void UAILightweightMovement::IntegrateMoveStates(int32 FirstState, int32 NumStates, float DeltaTime)
+{
+	TArray<FNavigationProjectionWork> Projections;
+	Projections.Reserve(NumStates);
+
+	TArray<FVector> PredictedFeet;
+	PredictedFeet.SetNumUninitialized(NumStates);
+
+	// Integrate velocity, facing and the predicted position
+	for (int32 Offset = 0; Offset < NumStates; ++Offset)
+	{
+		FMoveState& State = MoveStates[FirstState + Offset];
+
+		// Accelerate towards the desired velocity, or brake without one
+		const FVector Velocity2D(State.Velocity.X, State.Velocity.Y, 0.0f);
+		const float Rate = State.DesiredVelocity.IsNearlyZero() ? State.BrakingDeceleration : State.MaxAcceleration;
+		const FVector NewVelocity2D = FMath::VInterpConstantTo(Velocity2D, State.DesiredVelocity, DeltaTime, Rate);
+
+		const float VelocityZ = State.bFalling ? State.Velocity.Z + State.GravityZ * DeltaTime : 0.0f;
+		State.Velocity = FVector(NewVelocity2D.X, NewVelocity2D.Y, VelocityZ);
+
+		// Turn towards the controller or the movement direction
+		float TargetYaw = State.Yaw;
+		if (State.bHasDesiredYaw)
+		{
+			TargetYaw = State.DesiredYaw;
+		}
+		else if (State.bOrientToMovement && NewVelocity2D.SizeSquared() > 1.0f)
+		{
+			TargetYaw = NewVelocity2D.Rotation().Yaw;
+		}
+
+		State.Yaw = State.YawRate < 0.0f ? TargetYaw : FMath::FixedTurn(State.Yaw, TargetYaw, State.YawRate * DeltaTime);
+
+		const FVector Predicted = State.FeetLocation + State.Velocity * DeltaTime;
+		PredictedFeet[Offset] = Predicted;
+
+		// Walkers look for the navmesh within a step; fallers look between where they were and where they are now
+		const FVector Extent(State.Radius, State.Radius, State.StepHeight);
+		const float Above = State.bFalling ? FMath::Max(State.StepHeight, State.FeetLocation.Z - Predicted.Z) : State.StepHeight;
+		Projections.Emplace(Predicted, FBox(Predicted - Extent, Predicted + FVector(State.Radius, State.Radius, Above)));
+	}
+
+	// Project to the navmesh. Each batch builds its own nav query, so batches can run in parallel
+	NavData->BatchProjectPoints(Projections, NavFilter);
+
+	// Walkers that missed look for a slide along the navmesh edge, and for ground below
+	TArray<int32> MissedOffsets;
+	TArray<FNavigationProjectionWork> Probes;
+
+	for (int32 Offset = 0; Offset < NumStates; ++Offset)
+	{
+		FMoveState& State = MoveStates[FirstState + Offset];
+		const FNavigationProjectionWork& Projection = Projections[Offset];
+		const FVector& Predicted = PredictedFeet[Offset];
+
+		if (State.bFalling)
+		{
+			// Land on ground we reached or passed this step
+			if (Projection.bResult && Projection.OutLocation.Location.Z >= Predicted.Z)
+			{
+				State.FeetLocation = Projection.OutLocation.Location;
+				State.Velocity.Z = 0.0f;
+				State.bFalling = false;
+				State.bLanded = true;
+			}
+			else
+			{
+				State.FeetLocation = Predicted;
+
+				// We fell past the ground we expected without finding it, so let the full component sort it out
+				State.bLostGround = Predicted.Z < State.FallFloorZ - State.StepHeight;
+			}
+		}
+		else if (Projection.bResult)
+		{
+			State.FeetLocation = Projection.OutLocation.Location;
+		}
+		else
+		{
+			MissedOffsets.Add(Offset);
+
+			const FVector SlideExtent(State.Radius * 2.0f, State.Radius * 2.0f, State.StepHeight);
+			Probes.Emplace(Predicted, FBox(Predicted - SlideExtent, Predicted + SlideExtent));
+
+			const FVector FallExtent(State.Radius, State.Radius, LightweightFallProbeDistance);
+			Probes.Emplace(Predicted, FBox(Predicted - FallExtent, Predicted));
+		}
+	}
+
+	if (MissedOffsets.IsEmpty())
+	{
+		return;
+	}
+
+	NavData->BatchProjectPoints(Probes, NavFilter);
+
+	for (int32 MissIndex = 0; MissIndex < MissedOffsets.Num(); ++MissIndex)
+	{
+		const int32 Offset = MissedOffsets[MissIndex];
+		FMoveState& State = MoveStates[FirstState + Offset];
+		const FNavigationProjectionWork& Slide = Probes[MissIndex * 2];
+		const FNavigationProjectionWork& Fall = Probes[MissIndex * 2 + 1];
+
+		if (Fall.bResult && Fall.OutLocation.Location.Z < PredictedFeet[Offset].Z - State.StepHeight)
+		{
+			// Walked off a ledge onto lower ground
+			State.FeetLocation = PredictedFeet[Offset];
+			State.FallFloorZ = Fall.OutLocation.Location.Z;
+			State.bFalling = true;
+			State.bStartedFalling = true;
+		}
+		else if (Slide.bResult)
+		{
+			// Slide along the navmesh edge instead of stopping dead
+			const FVector Slid = Slide.OutLocation.Location;
+			State.Velocity = FVector((Slid.X - State.FeetLocation.X) / DeltaTime, (Slid.Y - State.FeetLocation.Y) / DeltaTime, 0.0f);
+			State.FeetLocation = Slid;
+		}
+		else
+		{
+			// Blocked
+			State.Velocity = FVector::ZeroVector;
+		}
+	}
+}
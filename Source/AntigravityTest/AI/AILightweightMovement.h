@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "AILightweightMovement.generated.h"
+
+class AAIController;
+class ACharacter;
+class ANavigationData;
+class UCharacterMovementComponent;
+
+/**
+ * Opt-in lightweight movement for crowds of AI characters.
+ * Registered characters have their character movement component switched off while they walk, and are moved
+ * by a batched pass instead: worker threads integrate walking and simple falling against navmesh-projected
+ * positions, then the results are written back to the actors in one game thread pass.
+ * A character goes back to the full movement component by itself whenever it needs it, e.g. to jump, be
+ * launched, play root motion or ragdoll, and comes back once it is walking again.
+ * The significance manager decides who is registered, so the full component still runs near the player
+ * and during knockback.
+ */
+UCLASS()
+class ANTIGRAVITYTEST_API UAILightweightMovement : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns the subsystem for the given world, or nullptr if lightweight movement is disabled */
+	static UAILightweightMovement* Get(const UWorld* World);
+
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Runs the batched movement pass */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Starts moving a character with the lightweight path whenever it is walking */
+	void AddAgent(ACharacter* Character);
+
+	/** Hands a character back to its movement component for good */
+	void RemoveAgent(ACharacter* Character);
+
+	/** Returns true if the character is currently moved by the lightweight path */
+	bool IsMovingLightweight(const ACharacter* Character) const;
+
+	/** Number of registered characters, lightweight or not */
+	int32 GetNumAgents() const { return Agents.Num(); }
+
+protected:
+	struct FAgent
+	{
+		const ACharacter* Key = nullptr;
+		TWeakObjectPtr<ACharacter> Character;
+		TWeakObjectPtr<UCharacterMovementComponent> Movement;
+		TWeakObjectPtr<AAIController> Controller;
+
+		// True while the movement component is switched off and we move the character
+		bool bLightweight = false;
+
+		// True while falling on the lightweight path
+		bool bFalling = false;
+
+		// Height of the ground found below when the agent started falling
+		float FallFloorZ = 0.0f;
+	};
+
+	/** Movement state of one lightweight agent, processed on worker threads */
+	struct FMoveState
+	{
+		int32 AgentIndex = INDEX_NONE;
+
+		// Inputs gathered on the game thread
+		FVector DesiredVelocity = FVector::ZeroVector;
+		float MaxAcceleration = 0.0f;
+		float BrakingDeceleration = 0.0f;
+		float GravityZ = 0.0f;
+		float Radius = 0.0f;
+		float HalfHeight = 0.0f;
+		float StepHeight = 0.0f;
+		float YawRate = 0.0f;
+		float DesiredYaw = 0.0f;
+		bool bOrientToMovement = false;
+		bool bHasDesiredYaw = false;
+
+		// Integrated state. FeetLocation is the bottom of the capsule
+		FVector FeetLocation = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+		float Yaw = 0.0f;
+		bool bFalling = false;
+		float FallFloorZ = 0.0f;
+
+		// Transitions the write back pass has to report to the movement component
+		bool bStartedFalling = false;
+		bool bLanded = false;
+
+		// True if the agent fell past the ground it expected and needs its full movement component
+		bool bLostGround = false;
+	};
+
+	/** Switches an agent to the lightweight path */
+	void StartLightweight(FAgent& Agent);
+
+	/** Hands an agent back to its movement component */
+	void StopLightweight(FAgent& Agent);
+
+	/** Returns true if the character needs its full movement component this frame */
+	bool NeedsFullMovement(const ACharacter& Character, const UCharacterMovementComponent& Movement, bool bFalling) const;
+
+	/** Integrates a range of move states and projects them to the navmesh. Runs on worker threads */
+	void IntegrateMoveStates(int32 FirstState, int32 NumStates, float DeltaTime);
+
+	/** Removes the agent at the given index, keeping the index map in sync */
+	void RemoveAgentAt(int32 AgentIndex);
+
+	TArray<FAgent> Agents;
+	TMap<const ACharacter*, int32> AgentIndices;
+
+	// Move states of this frame's lightweight agents
+	TArray<FMoveState> MoveStates;
+
+	// Navmesh used by this frame's pass
+	const ANavigationData* NavData = nullptr;
+	FSharedConstNavQueryFilter NavFilter;
+};
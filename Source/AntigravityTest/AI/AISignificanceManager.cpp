@@ -0,0 +1,294 @@
+#include "AI/AISignificanceManager.h"
+#include "AI/PlayerPerceptionCache.h"
+#include "AI/AILightweightMovement.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarAISignificanceEnabled(
+	TEXT("AI.Significance.Enabled"),
+	true,
+	TEXT("If true, AI tick rates are scaled by distance to the player and on-screen state. Disabling restores full rate."));
+
+UAISignificanceManager::UAISignificanceManager()
+{
+	// Near: full rate
+	FAISignificanceBucket& Near = Buckets.AddDefaulted_GetRef();
+	Near.MaxDistance = 1500.0f;
+
+	// Mid: StateTree and movement at roughly 20 Hz
+	FAISignificanceBucket& Mid = Buckets.AddDefaulted_GetRef();
+	Mid.MaxDistance = 4000.0f;
+	Mid.ActorTickInterval = 0.05f;
+	Mid.BrainTickInterval = 0.05f;
+	Mid.MovementTickInterval = 0.033f;
+	Mid.bLightweightMovement = true;
+
+	// Far: a few updates per second with simplified movement
+	FAISignificanceBucket& Far = Buckets.AddDefaulted_GetRef();
+	Far.MaxDistance = 8000.0f;
+	Far.ActorTickInterval = 0.25f;
+	Far.BrainTickInterval = 0.2f;
+	Far.MovementTickInterval = 0.1f;
+	Far.bSimplifiedMovement = true;
+	Far.bLightweightMovement = true;
+
+	// Dormant: anything further
+	FAISignificanceBucket& Dormant = Buckets.AddDefaulted_GetRef();
+	Dormant.MaxDistance = UE_BIG_NUMBER;
+	Dormant.ActorTickInterval = 1.0f;
+	Dormant.BrainTickInterval = 0.5f;
+	Dormant.MovementTickInterval = 0.25f;
+	Dormant.bSimplifiedMovement = true;
+	Dormant.bLightweightMovement = true;
+}
+
+void UAISignificanceManager::Deinitialize()
+{
+	Agents.Empty();
+	AgentIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UAISignificanceManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UAISignificanceManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAISignificanceManager, STATGROUP_Tickables);
+}
+
+void UAISignificanceManager::Tick(float DeltaTime)
+{
+	// Put everyone back at full rate once when the manager gets disabled
+	if (!CVarAISignificanceEnabled.GetValueOnGameThread())
+	{
+		if (bThrottling)
+		{
+			for (FAgent& Agent : Agents)
+			{
+				ApplyBucket(Agent, 0);
+			}
+			bThrottling = false;
+		}
+		return;
+	}
+
+	bThrottling = true;
+
+	TimeUntilEvaluation -= DeltaTime;
+	if (TimeUntilEvaluation > 0.0f)
+	{
+		return;
+	}
+	TimeUntilEvaluation = EvaluationInterval;
+
+	EvaluateAgents();
+}
+
+void UAISignificanceManager::RegisterAgent(APawn* Agent)
+{
+	if (!IsValid(Agent) || AgentIndices.Contains(Agent))
+	{
+		return;
+	}
+
+	FAgent& NewAgent = Agents.AddDefaulted_GetRef();
+	NewAgent.Key = Agent;
+	NewAgent.Pawn = Agent;
+
+	if (ACharacter* Character = Cast<ACharacter>(Agent))
+	{
+		NewAgent.Movement = Character->GetCharacterMovement();
+		NewAgent.Mesh = Character->GetMesh();
+		NewAgent.DefaultAnimTickOption = Character->GetMesh()->VisibilityBasedAnimTickOption;
+
+		if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+		{
+			NewAgent.DefaultMaxSimulationIterations = Movement->MaxSimulationIterations;
+			NewAgent.bDefaultPhysicsInteraction = Movement->bEnablePhysicsInteraction;
+		}
+	}
+
+	if (AAIController* Controller = Cast<AAIController>(Agent->GetController()))
+	{
+		NewAgent.Brain = Controller->FindComponentByClass<UBrainComponent>();
+	}
+
+	AgentIndices.Add(Agent, Agents.Num() - 1);
+
+	// New agents start at full rate and get bucketed on the next evaluation
+	NewAgent.Bucket = 0;
+}
+
+void UAISignificanceManager::UnregisterAgent(APawn* Agent)
+{
+	if (const int32* AgentIndex = AgentIndices.Find(Agent))
+	{
+		ApplyBucket(Agents[*AgentIndex], 0);
+		RemoveAgentAt(*AgentIndex);
+	}
+}
+
+void UAISignificanceManager::RemoveAgentAt(int32 AgentIndex)
+{
+	AgentIndices.Remove(Agents[AgentIndex].Key);
+
+	// The last agent moves into the freed slot
+	const int32 LastIndex = Agents.Num() - 1;
+	if (AgentIndex != LastIndex)
+	{
+		AgentIndices.Add(Agents[LastIndex].Key, AgentIndex);
+	}
+	Agents.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+}
+
+void UAISignificanceManager::PromoteAgent(APawn* Agent)
+{
+	if (const int32* AgentIndex = AgentIndices.Find(Agent))
+	{
+		FAgent& PromotedAgent = Agents[*AgentIndex];
+		PromotedAgent.PromotedUntil = GetWorld()->GetTimeSeconds() + PromotionDuration;
+
+		if (PromotedAgent.Bucket != 0)
+		{
+			ApplyBucket(PromotedAgent, 0);
+		}
+	}
+}
+
+int32 UAISignificanceManager::GetAgentBucket(const APawn* Agent) const
+{
+	const int32* AgentIndex = AgentIndices.Find(Agent);
+	return AgentIndex ? Agents[*AgentIndex].Bucket : INDEX_NONE;
+}
+
+void UAISignificanceManager::EvaluateAgents()
+{
+	if (Buckets.IsEmpty())
+	{
+		return;
+	}
+
+	// Distances come from the shared perception cache's batched pass when available
+	UPlayerPerceptionCache* PerceptionCache = UPlayerPerceptionCache::Get(GetWorld());
+	const APawn* PlayerPawn = nullptr;
+	FVector PlayerLocation = FVector::ZeroVector;
+	if (PerceptionCache)
+	{
+		PlayerPawn = PerceptionCache->GetPlayerPawn(0);
+		PlayerLocation = PerceptionCache->GetPlayerLocation(0);
+	}
+	else if (const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		PlayerPawn = PlayerController->GetPawn();
+		PlayerLocation = PlayerPawn ? PlayerPawn->GetActorLocation() : FVector::ZeroVector;
+	}
+
+	for (int32 AgentIndex = Agents.Num() - 1; AgentIndex >= 0; --AgentIndex)
+	{
+		FAgent& Agent = Agents[AgentIndex];
+		APawn* Pawn = Agent.Pawn.Get();
+
+		// Drop agents that went away without unregistering
+		if (!Pawn)
+		{
+			RemoveAgentAt(AgentIndex);
+			continue;
+		}
+
+		// Placed pawns may have been possessed after they registered
+		if (!Agent.Brain.IsValid())
+		{
+			if (AAIController* Controller = Cast<AAIController>(Pawn->GetController()))
+			{
+				Agent.Brain = Controller->FindComponentByClass<UBrainComponent>();
+			}
+		}
+
+		// Without a player there's nothing to be significant to, so stay at full rate. Promoted agents also stay there for a while
+		int32 Bucket = 0;
+		if (PlayerPawn && GetWorld()->GetTimeSeconds() >= Agent.PromotedUntil)
+		{
+			const float DistanceSquared = PerceptionCache
+				? PerceptionCache->GetDistanceSquaredToPlayer(Pawn)
+				: float(FVector::DistSquared(Pawn->GetActorLocation(), PlayerLocation));
+
+			while (Bucket < Buckets.Num() - 1 && DistanceSquared > FMath::Square(Buckets[Bucket].MaxDistance))
+			{
+				++Bucket;
+			}
+
+			// Off-screen AIs drop one more bucket, except close ones that may be about to attack from behind the camera
+			if (Bucket > 0 && !Pawn->WasRecentlyRendered(OffscreenTolerance))
+			{
+				Bucket = FMath::Min(Bucket + 1, Buckets.Num() - 1);
+			}
+		}
+
+		if (Bucket != Agent.Bucket)
+		{
+			ApplyBucket(Agent, Bucket);
+		}
+	}
+}
+
+void UAISignificanceManager::ApplyBucket(FAgent& Agent, int32 Bucket) const
+{
+	Agent.Bucket = Bucket;
+
+	if (!Buckets.IsValidIndex(Bucket))
+	{
+		return;
+	}
+
+	const FAISignificanceBucket& Settings = Buckets[Bucket];
+
+	if (APawn* Pawn = Agent.Pawn.Get())
+	{
+		Pawn->SetActorTickInterval(Settings.ActorTickInterval);
+	}
+
+	if (UBrainComponent* Brain = Agent.Brain.Get())
+	{
+		Brain->SetComponentTickInterval(Settings.BrainTickInterval);
+	}
+
+	if (UCharacterMovementComponent* Movement = Agent.Movement.Get())
+	{
+		Movement->SetComponentTickInterval(Settings.MovementTickInterval);
+		Movement->MaxSimulationIterations = Settings.bSimplifiedMovement ? 1 : Agent.DefaultMaxSimulationIterations;
+		Movement->bEnablePhysicsInteraction = Settings.bSimplifiedMovement ? false : Agent.bDefaultPhysicsInteraction;
+	}
+
+	// Characters in lightweight buckets are moved by the batched pass, which only runs while it's enabled.
+	// The first bucket, and so promoted agents, always get their full movement component back
+	if (UAILightweightMovement* LightweightMovement = GetWorld()->GetSubsystem<UAILightweightMovement>())
+	{
+		if (ACharacter* Character = Cast<ACharacter>(Agent.Pawn.Get()))
+		{
+			if (Settings.bLightweightMovement)
+			{
+				LightweightMovement->AddAgent(Character);
+			}
+			else
+			{
+				LightweightMovement->RemoveAgent(Character);
+			}
+		}
+	}
+
+	// Past the first bucket, only montages keep ticking while the mesh isn't rendered, so attack notifies still fire
+	if (USkeletalMeshComponent* Mesh = Agent.Mesh.Get())
+	{
+		Mesh->VisibilityBasedAnimTickOption = Bucket == 0 ? Agent.DefaultAnimTickOption : EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
+}
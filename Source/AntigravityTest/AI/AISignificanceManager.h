@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "AISignificanceManager.generated.h"
+
+class APawn;
+class UBrainComponent;
+class UCharacterMovementComponent;
+class USkeletalMeshComponent;
+
+/**
+ * Tick settings applied to every AI in one significance bucket.
+ */
+USTRUCT()
+struct FAISignificanceBucket
+{
+	GENERATED_BODY()
+
+	/** AIs closer than this to the player fall in this bucket, unless an earlier bucket already took them */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (Units = "cm"))
+	float MaxDistance = 0.0f;
+
+	/** Tick interval of the AI pawn */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (Units = "s"))
+	float ActorTickInterval = 0.0f;
+
+	/** Tick interval of the controller's brain component (StateTree) */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (Units = "s"))
+	float BrainTickInterval = 0.0f;
+
+	/** Tick interval of the character movement component */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (Units = "s"))
+	float MovementTickInterval = 0.0f;
+
+	/** If true, movement runs a single simulation iteration and skips physics interaction */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	bool bSimplifiedMovement = false;
+
+	/** If true, walking characters are moved by the batched lightweight movement pass while AI.LightweightMovement.Enabled is set */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	bool bLightweightMovement = false;
+};
+
+/**
+ * Buckets registered AIs by distance to the player and on-screen state, and scales
+ * their actor, StateTree and movement tick rates per bucket.
+ * Off-screen AIs are pushed one bucket further out than their distance alone would place them.
+ */
+UCLASS(Config = Game)
+class ANTIGRAVITYTEST_API UAISignificanceManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UAISignificanceManager();
+
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Starts managing the tick rates of an AI pawn */
+	void RegisterAgent(APawn* Agent);
+
+	/** Restores full tick rates and stops managing an AI pawn */
+	void UnregisterAgent(APawn* Agent);
+
+	/** Forces an agent into the most significant bucket for PromotionDuration, e.g. while a knockback plays out */
+	void PromoteAgent(APawn* Agent);
+
+	/** Bucket the agent is currently in, or INDEX_NONE if it isn't registered */
+	int32 GetAgentBucket(const APawn* Agent) const;
+
+	/** Number of registered agents */
+	int32 GetNumAgents() const { return Agents.Num(); }
+
+protected:
+	struct FAgent
+	{
+		const APawn* Key = nullptr;
+		TWeakObjectPtr<APawn> Pawn;
+		TWeakObjectPtr<UCharacterMovementComponent> Movement;
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+		TWeakObjectPtr<UBrainComponent> Brain;
+
+		// Movement settings to restore when leaving a simplified bucket
+		int32 DefaultMaxSimulationIterations = 8;
+		bool bDefaultPhysicsInteraction = true;
+		EVisibilityBasedAnimTickOption DefaultAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPose;
+
+		int32 Bucket = 0;
+
+		// Game time until which the agent is held in the first bucket
+		double PromotedUntil = 0.0;
+	};
+
+	/** Picks a bucket for each agent and applies the bucket settings where they changed */
+	void EvaluateAgents();
+
+	/** Removes the agent at the given index, keeping the index map in sync */
+	void RemoveAgentAt(int32 AgentIndex);
+
+	/** Applies a bucket's settings to an agent */
+	void ApplyBucket(FAgent& Agent, int32 Bucket) const;
+
+	/** Buckets ordered from most to least significant. The first bucket should run at full rate; the last one catches everything beyond the previous ones */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	TArray<FAISignificanceBucket> Buckets;
+
+	/** Seconds an AI can go unrendered before it is considered off-screen */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (Units = "s"))
+	float OffscreenTolerance = 0.5f;
+
+	/** Seconds a promoted agent stays in the first bucket */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (Units = "s"))
+	float PromotionDuration = 1.5f;
+
+	/** Seconds between significance evaluations */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (Units = "s"))
+	float EvaluationInterval = 0.2f;
+
+	TArray<FAgent> Agents;
+	TMap<const APawn*, int32> AgentIndices;
+
+	float TimeUntilEvaluation = 0.0f;
+
+	/** True while agents are being throttled; false after the manager was disabled at runtime and everyone was restored */
+	bool bThrottling = false;
+};
@@ -0,0 +1,217 @@
+#include "AI/PlayerPerceptionCache.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+
+static TAutoConsoleVariable<bool> CVarPlayerPerceptionCacheEnabled(
+	TEXT("AI.PlayerPerceptionCache.Enabled"),
+	true,
+	TEXT("If true, StateTree player lookups read the shared per-frame player perception cache."));
+
+UPlayerPerceptionCache* UPlayerPerceptionCache::Get(const UWorld* World)
+{
+	if (!World || !CVarPlayerPerceptionCacheEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UPlayerPerceptionCache>();
+}
+
+void UPlayerPerceptionCache::Deinitialize()
+{
+	for (const TWeakObjectPtr<APawn>& WeakAgent : Agents)
+	{
+		if (APawn* Agent = WeakAgent.Get())
+		{
+			Agent->OnEndPlay.RemoveDynamic(this, &UPlayerPerceptionCache::OnAgentEndPlay);
+		}
+	}
+
+	Agents.Empty();
+	AgentKeys.Empty();
+	AgentDistancesSquared.Empty();
+	AgentIndices.Empty();
+	PlayerPawns.Empty();
+	PlayerLocations.Empty();
+	PlayerVelocities.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UPlayerPerceptionCache::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+APawn* UPlayerPerceptionCache::GetPlayerPawn(int32 PlayerIndex)
+{
+	RefreshIfStale();
+	return PlayerPawns.IsValidIndex(PlayerIndex) ? PlayerPawns[PlayerIndex].Get() : nullptr;
+}
+
+FVector UPlayerPerceptionCache::GetPlayerLocation(int32 PlayerIndex)
+{
+	RefreshIfStale();
+	return PlayerLocations.IsValidIndex(PlayerIndex) ? PlayerLocations[PlayerIndex] : FVector::ZeroVector;
+}
+
+FVector UPlayerPerceptionCache::GetPlayerVelocity(int32 PlayerIndex)
+{
+	RefreshIfStale();
+	return PlayerVelocities.IsValidIndex(PlayerIndex) ? PlayerVelocities[PlayerIndex] : FVector::ZeroVector;
+}
+
+float UPlayerPerceptionCache::GetDistanceSquaredToPlayer(APawn* Agent)
+{
+	RefreshIfStale();
+
+	if (!IsValid(Agent) || !PlayerPawns.IsValidIndex(0) || !PlayerPawns[0].IsValid())
+	{
+		return -1.0f;
+	}
+
+	if (const int32* AgentIndex = AgentIndices.Find(Agent))
+	{
+		return AgentDistancesSquared[*AgentIndex];
+	}
+
+	// first query from this agent; it joins the batch from the next frame on
+	RegisterAgent(Agent);
+	return AgentDistancesSquared[AgentIndices.FindChecked(Agent)];
+}
+
+void UPlayerPerceptionCache::RegisterAgent(APawn* Agent)
+{
+	if (!IsValid(Agent) || AgentIndices.Contains(Agent))
+	{
+		return;
+	}
+
+	// compute this frame's distance right away, the batch already ran
+	float DistanceSquared = -1.0f;
+	if (PlayerPawns.IsValidIndex(0) && PlayerPawns[0].IsValid())
+	{
+		DistanceSquared = float(FVector::DistSquared(Agent->GetActorLocation(), PlayerLocations[0]));
+	}
+
+	AgentIndices.Add(Agent, Agents.Add(Agent));
+	AgentKeys.Add(Agent);
+	AgentDistancesSquared.Add(DistanceSquared);
+
+	Agent->OnEndPlay.AddUniqueDynamic(this, &UPlayerPerceptionCache::OnAgentEndPlay);
+}
+
+void UPlayerPerceptionCache::UnregisterAgent(APawn* Agent)
+{
+	if (const int32* AgentIndex = AgentIndices.Find(Agent))
+	{
+		Agent->OnEndPlay.RemoveDynamic(this, &UPlayerPerceptionCache::OnAgentEndPlay);
+		RemoveAgentAt(*AgentIndex);
+	}
+}
+
+void UPlayerPerceptionCache::OnAgentEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterAgent(Cast<APawn>(Actor));
+}
+
+void UPlayerPerceptionCache::RemoveAgentAt(int32 AgentIndex)
+{
+	AgentIndices.Remove(AgentKeys[AgentIndex]);
+
+	// the last agent moves into the freed slot
+	const int32 LastIndex = Agents.Num() - 1;
+	if (AgentIndex != LastIndex)
+	{
+		AgentIndices.Add(AgentKeys[LastIndex], AgentIndex);
+	}
+
+	Agents.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	AgentKeys.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	AgentDistancesSquared.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+}
+
+void UPlayerPerceptionCache::RefreshIfStale()
+{
+	if (LastRefreshFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastRefreshFrame = GFrameCounter;
+
+	// Gather every local player once
+	PlayerPawns.Reset();
+	PlayerLocations.Reset();
+	PlayerVelocities.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+		PlayerPawns.Add(Pawn);
+		PlayerLocations.Add(Pawn ? Pawn->GetActorLocation() : FVector::ZeroVector);
+		PlayerVelocities.Add(Pawn ? Pawn->GetVelocity() : FVector::ZeroVector);
+	}
+
+	const int32 NumAgents = Agents.Num();
+	if (NumAgents == 0)
+	{
+		return;
+	}
+
+	// Without a player there are no distances to compute
+	if (!PlayerPawns.IsValidIndex(0) || !PlayerPawns[0].IsValid())
+	{
+		for (float& DistanceSquared : AgentDistancesSquared)
+		{
+			DistanceSquared = -1.0f;
+		}
+		return;
+	}
+
+	// Drop agents that went away without ending play
+	for (int32 AgentIndex = NumAgents - 1; AgentIndex >= 0; --AgentIndex)
+	{
+		if (!Agents[AgentIndex].IsValid())
+		{
+			RemoveAgentAt(AgentIndex);
+		}
+	}
+
+	// Gather agent offsets from the player into padded SoA arrays
+	const FVector PlayerLocation = PlayerLocations[0];
+	const int32 NumLiveAgents = Agents.Num();
+	const int32 NumPadded = Align(NumLiveAgents, 4);
+	OffsetX.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+	OffsetY.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+	OffsetZ.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+	AgentDistancesSquared.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+
+	for (int32 AgentIndex = 0; AgentIndex < NumPadded; ++AgentIndex)
+	{
+		const FVector Offset = AgentIndex < NumLiveAgents ? Agents[AgentIndex]->GetActorLocation() - PlayerLocation : FVector::ZeroVector;
+		OffsetX[AgentIndex] = float(Offset.X);
+		OffsetY[AgentIndex] = float(Offset.Y);
+		OffsetZ[AgentIndex] = float(Offset.Z);
+	}
+
+	// Squared distances, four agents at a time
+	for (int32 AgentIndex = 0; AgentIndex < NumPadded; AgentIndex += 4)
+	{
+		const VectorRegister4Float X = VectorLoad(&OffsetX[AgentIndex]);
+		const VectorRegister4Float Y = VectorLoad(&OffsetY[AgentIndex]);
+		const VectorRegister4Float Z = VectorLoad(&OffsetZ[AgentIndex]);
+
+		VectorRegister4Float DistanceSquared = VectorMultiply(X, X);
+		DistanceSquared = VectorMultiplyAdd(Y, Y, DistanceSquared);
+		DistanceSquared = VectorMultiplyAdd(Z, Z, DistanceSquared);
+
+		VectorStore(DistanceSquared, &AgentDistancesSquared[AgentIndex]);
+	}
+
+	AgentDistancesSquared.SetNum(NumLiveAgents, EAllowShrinking::No);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PlayerPerceptionCache.generated.h"
+
+class APawn;
+
+/**
+ * Shared per-frame snapshot of the local players and of every registered AI's distance to the first player.
+ * Refreshed lazily on the first query of each frame, so hundreds of StateTree tasks share one player lookup
+ * and one batched distance pass instead of each doing their own.
+ */
+UCLASS()
+class ANTIGRAVITYTEST_API UPlayerPerceptionCache : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns the cache for the given world, or nullptr if it is disabled */
+	static UPlayerPerceptionCache* Get(const UWorld* World);
+
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Pawn possessed by the given local player, or nullptr */
+	APawn* GetPlayerPawn(int32 PlayerIndex = 0);
+
+	/** Location of the given local player's pawn this frame. Zero if there is none */
+	FVector GetPlayerLocation(int32 PlayerIndex = 0);
+
+	/** Velocity of the given local player's pawn this frame. Zero if there is none */
+	FVector GetPlayerVelocity(int32 PlayerIndex = 0);
+
+	/**
+	 * Squared distance from the agent to the first player's pawn this frame.
+	 * Registers the agent on first use. Returns a negative value if there is no player pawn.
+	 */
+	float GetDistanceSquaredToPlayer(APawn* Agent);
+
+	/** Adds an agent to the batched distance pass */
+	void RegisterAgent(APawn* Agent);
+
+	/** Removes an agent from the batched distance pass */
+	void UnregisterAgent(APawn* Agent);
+
+	/** Number of agents in the batched distance pass */
+	int32 GetNumAgents() const { return Agents.Num(); }
+
+protected:
+	/** Rebuilds the player arrays and the agent distances if this frame hasn't been processed yet */
+	void RefreshIfStale();
+
+	/** Removes agents as they leave play */
+	UFUNCTION()
+	void OnAgentEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	/** Removes the agent at the given index, keeping the index map in sync */
+	void RemoveAgentAt(int32 AgentIndex);
+
+	// Local players, one entry per player controller index
+	TArray<TWeakObjectPtr<APawn>> PlayerPawns;
+	TArray<FVector> PlayerLocations;
+	TArray<FVector> PlayerVelocities;
+
+	// Registered agents and their squared distance to the first player, one entry per index
+	TArray<TWeakObjectPtr<APawn>> Agents;
+	TArray<const APawn*> AgentKeys;
+	TArray<float> AgentDistancesSquared;
+	TMap<const APawn*, int32> AgentIndices;
+
+	// Scratch arrays for the batched pass: agent offsets from the player, padded to a multiple of four
+	TArray<float> OffsetX;
+	TArray<float> OffsetY;
+	TArray<float> OffsetZ;
+
+	// Frame the cache was last refreshed on
+	uint64 LastRefreshFrame = MAX_uint64;
+};
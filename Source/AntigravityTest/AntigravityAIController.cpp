@@ -3,6 +3,7 @@
 #include "AntigravityAIController.h"
 #include "GameFramework/Character.h"
 #include "Engine/World.h"
+#include "AI/AISignificanceManager.h"
 
 AAntigravityAIController::AAntigravityAIController()
 {
@@ -15,15 +16,29 @@ void AAntigravityAIController::OnPossess(APawn* InPawn)
 	if (UWorld* World = GetWorld())
 	{
 		World->GetTimerManager().SetTimer(TimerHandle_Jump, this, &AAntigravityAIController::PerformJump, 3.0f, true);
+
+		// Scale the pawn's tick rates and movement by distance to the player
+		if (UAISignificanceManager* SignificanceManager = World->GetSubsystem<UAISignificanceManager>())
+		{
+			SignificanceManager->RegisterAgent(InPawn);
+		}
 	}
 }
 
 void AAntigravityAIController::OnUnPossess()
 {
+	APawn* OldPawn = GetPawn();
+
 	Super::OnUnPossess();
 	if (UWorld* World = GetWorld())
 	{
 		World->GetTimerManager().ClearTimer(TimerHandle_Jump);
+
+		// Give the pawn back its full tick rates and movement
+		if (UAISignificanceManager* SignificanceManager = World->GetSubsystem<UAISignificanceManager>())
+		{
+			SignificanceManager->UnregisterAgent(OldPawn);
+		}
 	}
 }
 
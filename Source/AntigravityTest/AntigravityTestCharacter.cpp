@@ -166,9 +166,18 @@ void AAntigravityTestCharacter::PossessedBy(AController* NewController)
 
 void AAntigravityTestCharacter::DebugAddTestItem()
 {
+#if !UE_BUILD_SHIPPING
+	// Clients can't mint items, use the server's (or PIE listen server's) character instead
+	if (!HasAuthority())
+	{
+		UE_LOG(LogAntigravityTest, Warning, TEXT("Debug: DebugAddTestItem only works on the server"));
+		return;
+	}
+
 	if (InventoryComponent && DebugItemDef)
 	{
 		InventoryComponent->AddItem(DebugItemDef, 1);
 		UE_LOG(LogAntigravityTest, Log, TEXT("Debug: Added item %s"), *DebugItemDef->GetName());
 	}
+#endif
 }
@@ -112,7 +112,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	class UInventoryComponent* GetInventoryComponent() const { return InventoryComponent; }
 
-	// Debug function to add test item
+	// Debug function to add test item. Inventory is server authoritative, so this only works on the server and does nothing in shipping builds
 	UFUNCTION(BlueprintCallable, Category = "Debug")
 	void DebugAddTestItem();
 
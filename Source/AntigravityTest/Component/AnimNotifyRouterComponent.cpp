@@ -0,0 +1,74 @@
+#include "AnimNotifyRouterComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+
+UAnimNotifyRouterComponent::UAnimNotifyRouterComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+bool UAnimNotifyRouterComponent::RouteNotify(USkeletalMeshComponent* Mesh, EAnimNotifyRoute Route, FName Param)
+{
+	if (!Mesh)
+	{
+		return false;
+	}
+
+	// The mesh usually carries no other user data, so this is a short scan of a tiny array
+	if (const UAnimNotifyRouterUserData* RouterData = Mesh->GetAssetUserData<UAnimNotifyRouterUserData>())
+	{
+		if (const UAnimNotifyRouterComponent* Router = RouterData->Router.Get())
+		{
+			return Router->ExecuteRoute(Route, Param);
+		}
+	}
+
+	return false;
+}
+
+void UAnimNotifyRouterComponent::SetRouteHandler(EAnimNotifyRoute Route, FAnimNotifyRouteHandler Handler)
+{
+	check(Route < EAnimNotifyRoute::Num);
+	Handlers[(int32)Route] = MoveTemp(Handler);
+}
+
+bool UAnimNotifyRouterComponent::ExecuteRoute(EAnimNotifyRoute Route, FName Param) const
+{
+	return Handlers[(int32)Route].ExecuteIfBound(Param);
+}
+
+void UAnimNotifyRouterComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Editor worlds keep casting, so the cache never ends up on a saved mesh
+	const UWorld* World = GetWorld();
+	if (!Mesh || !World || !World->IsGameWorld())
+	{
+		return;
+	}
+
+	UAnimNotifyRouterUserData* RouterData = Mesh->GetAssetUserData<UAnimNotifyRouterUserData>();
+	if (!RouterData)
+	{
+		RouterData = NewObject<UAnimNotifyRouterUserData>(Mesh);
+		Mesh->AddAssetUserData(RouterData);
+	}
+
+	RouterData->Router = this;
+}
+
+void UAnimNotifyRouterComponent::OnUnregister()
+{
+	if (Mesh)
+	{
+		// Only drop the cache if it still points at us
+		const UAnimNotifyRouterUserData* RouterData = Mesh->GetAssetUserData<UAnimNotifyRouterUserData>();
+		if (RouterData && (!RouterData->Router.IsValid() || RouterData->Router.Get() == this))
+		{
+			Mesh->RemoveUserDataOfClass(UAnimNotifyRouterUserData::StaticClass());
+		}
+	}
+
+	Super::OnUnregister();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Containers/StaticArray.h"
+#include "Engine/AssetUserData.h"
+#include "AnimNotifyRouterComponent.generated.h"
+
+class USkeletalMeshComponent;
+class UAnimNotifyRouterComponent;
+
+// Gameplay notifies that can be routed to their owner without casting
+enum class EAnimNotifyRoute : uint8
+{
+	AttackTrace,
+	CheckCombo,
+	CheckChargedAttack,
+	EndDash,
+	Num
+};
+
+// Handler for a routed notify. Param carries the notify's data, e.g. the attack trace bone
+DECLARE_DELEGATE_OneParam(FAnimNotifyRouteHandler, FName /*Param*/);
+
+// Caches a router on the mesh it routes, so notifies reach their handlers straight from the mesh they fire on.
+// Only added to meshes in game worlds and never saved
+UCLASS(Transient)
+class ANTIGRAVITYTEST_API UAnimNotifyRouterUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	// Router that handles notifies fired on the mesh
+	UPROPERTY(Transient)
+	TWeakObjectPtr<UAnimNotifyRouterComponent> Router;
+};
+
+// Routes gameplay anim notifies from a skeletal mesh straight to typed handlers bound once by the owner.
+// The router caches itself on its mesh as asset user data when it registers, so notifies fired from that mesh
+// find their handler on the mesh itself instead of casting the owner to an interface every time.
+// Handlers run synchronously from the notify, so branching points still fire at their exact montage time
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class ANTIGRAVITYTEST_API UAnimNotifyRouterComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UAnimNotifyRouterComponent();
+
+	// Run the mesh's handler for the route right away. Returns false if the mesh has no handler for the route, so the notify can fall back
+	static bool RouteNotify(USkeletalMeshComponent* Mesh, EAnimNotifyRoute Route, FName Param = NAME_None);
+
+	// Set the mesh whose notifies are routed. Usually called from the owner's constructor
+	void SetMesh(USkeletalMeshComponent* InMesh) { Mesh = InMesh; }
+
+	// Bind the handler for a route. Usually called from the owner's constructor
+	void SetRouteHandler(EAnimNotifyRoute Route, FAnimNotifyRouteHandler Handler);
+
+	// Run the handler for a route. Returns false if none is bound
+	bool ExecuteRoute(EAnimNotifyRoute Route, FName Param) const;
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+	// Mesh whose notifies are routed
+	UPROPERTY()
+	TObjectPtr<USkeletalMeshComponent> Mesh;
+
+	// Handlers, one per route
+	TStaticArray<FAnimNotifyRouteHandler, (int32)EAnimNotifyRoute::Num> Handlers;
+};
@@ -0,0 +1,192 @@
+#include "InputBufferComponent.h"
+
+UInputBufferComponent::UInputBufferComponent()
+{
+	// Only ticks while a replay is in progress
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UInputBufferComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Fire every replay input whose delayed frame has come up. Handlers may stop the replay
+	const uint64 ElapsedFrames = GFrameCounter - ReplayStartFrame;
+	while (IsReplaying() && ReplayLog[ReplayIndex].Frame + ReplayLatencyFrames <= ElapsedFrames)
+	{
+		const EBufferedInputType Type = ReplayLog[ReplayIndex++].Type;
+		OnReplayInput.Broadcast(Type);
+	}
+
+	if (!IsReplaying())
+	{
+		StopReplay();
+	}
+}
+
+void UInputBufferComponent::BufferInput(EBufferedInputType Type)
+{
+	// Overwrite the oldest input when full
+	if (Count == Capacity)
+	{
+		RemoveInputAt(0);
+	}
+
+	FBufferedInput& Input = Entries[GetRingIndex(Count)];
+	Input.Type = Type;
+	Input.Frame = GFrameCounter;
+	++Count;
+
+	RecordInput(Type);
+}
+
+void UInputBufferComponent::RecordInput(EBufferedInputType Type)
+{
+	if (bRecording)
+	{
+		FBufferedInput& Input = RecordedLog.AddDefaulted_GetRef();
+		Input.Type = Type;
+		Input.Frame = GFrameCounter - RecordStartFrame;
+	}
+}
+
+bool UInputBufferComponent::ConsumeInput(EBufferedInputType TypeMask, int32 MaxAgeFrames, EBufferedInputType* OutType)
+{
+	int32 Offset = 0;
+	while (Offset < Count)
+	{
+		const FBufferedInput& Input = Entries[GetRingIndex(Offset)];
+
+		// Leave other kinds of input for their own consumers
+		if (!EnumHasAnyFlags(Input.Type, TypeMask))
+		{
+			++Offset;
+			continue;
+		}
+
+		// Drop stale inputs so they can't fire later
+		if (int64(GFrameCounter - Input.Frame) > MaxAgeFrames)
+		{
+			RemoveInputAt(Offset);
+			continue;
+		}
+
+		if (OutType)
+		{
+			*OutType = Input.Type;
+		}
+
+		RemoveInputAt(Offset);
+		return true;
+	}
+
+	return false;
+}
+
+bool UInputBufferComponent::HasInput(EBufferedInputType TypeMask, int32 MaxAgeFrames) const
+{
+	for (int32 Offset = 0; Offset < Count; ++Offset)
+	{
+		const FBufferedInput& Input = Entries[GetRingIndex(Offset)];
+		if (EnumHasAnyFlags(Input.Type, TypeMask) && int64(GFrameCounter - Input.Frame) <= MaxAgeFrames)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UInputBufferComponent::ClearInputs(EBufferedInputType TypeMask)
+{
+	int32 Offset = 0;
+	while (Offset < Count)
+	{
+		if (EnumHasAnyFlags(Entries[GetRingIndex(Offset)].Type, TypeMask))
+		{
+			RemoveInputAt(Offset);
+		}
+		else
+		{
+			++Offset;
+		}
+	}
+}
+
+void UInputBufferComponent::SaveState(FInputBufferState& OutState) const
+{
+	OutState.Entries.Reset(Count);
+	for (int32 Offset = 0; Offset < Count; ++Offset)
+	{
+		OutState.Entries.Add(Entries[GetRingIndex(Offset)]);
+	}
+}
+
+void UInputBufferComponent::RestoreState(const FInputBufferState& State)
+{
+	// Keep the newest inputs if the state doesn't fit
+	const int32 First = FMath::Max(0, State.Entries.Num() - Capacity);
+
+	Head = 0;
+	Count = State.Entries.Num() - First;
+	for (int32 Offset = 0; Offset < Count; ++Offset)
+	{
+		Entries[Offset] = State.Entries[First + Offset];
+	}
+}
+
+void UInputBufferComponent::StartRecording()
+{
+	RecordedLog.Reset();
+	RecordStartFrame = GFrameCounter;
+	bRecording = true;
+}
+
+TArray<FBufferedInput> UInputBufferComponent::StopRecording()
+{
+	bRecording = false;
+	return MoveTemp(RecordedLog);
+}
+
+void UInputBufferComponent::StartReplay(const TArray<FBufferedInput>& Log, int32 LatencyFrames)
+{
+	// Start from an empty buffer so live inputs from before the replay can't leak into it
+	Head = 0;
+	Count = 0;
+
+	ReplayLog = Log;
+	ReplayIndex = 0;
+	ReplayLatencyFrames = FMath::Max(0, LatencyFrames);
+	ReplayStartFrame = GFrameCounter;
+
+	SetComponentTickEnabled(IsReplaying());
+}
+
+void UInputBufferComponent::StopReplay()
+{
+	ReplayLog.Reset();
+	ReplayIndex = 0;
+
+	SetComponentTickEnabled(false);
+}
+
+void UInputBufferComponent::RemoveInputAt(int32 Offset)
+{
+	check(Offset >= 0 && Offset < Count);
+
+	// Removing the oldest input only moves the head
+	if (Offset == 0)
+	{
+		Head = GetRingIndex(1);
+		--Count;
+		return;
+	}
+
+	// Otherwise shift the newer inputs back to keep them in arrival order
+	for (int32 Index = Offset; Index < Count - 1; ++Index)
+	{
+		Entries[GetRingIndex(Index)] = Entries[GetRingIndex(Index + 1)];
+	}
+	--Count;
+}
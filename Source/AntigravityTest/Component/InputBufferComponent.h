@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Containers/StaticArray.h"
+#include "InputBufferComponent.generated.h"
+
+// Kinds of input that can be buffered. Flags, so a consumer can accept several kinds at once
+enum class EBufferedInputType : uint8
+{
+	None = 0,
+	ComboAttack = 1 << 0,
+	ChargedAttackPress = 1 << 1,
+	ChargedAttackRelease = 1 << 2,
+	Jump = 1 << 3,
+	JumpRelease = 1 << 4,
+	Dash = 1 << 5,
+};
+ENUM_CLASS_FLAGS(EBufferedInputType);
+
+// A single buffered or recorded input
+struct FBufferedInput
+{
+	EBufferedInputType Type = EBufferedInputType::None;
+
+	// Engine frame the input arrived on. Relative to the start of the recording in recorded logs
+	uint64 Frame = 0;
+};
+
+// Copy of the buffer contents, used to rewind it for rollback-style replays
+struct FInputBufferState
+{
+	TArray<FBufferedInput> Entries;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnBufferedInputReplayed, EBufferedInputType /*Type*/);
+
+// Fixed-size ring buffer of frame-stamped, typed inputs.
+// Owners buffer inputs they can't act on yet, and animation notifies or state changes consume them later,
+// oldest first. Inputs are aged in engine frames, never in world time. Every input routed through the component can also be recorded and replayed with added
+// frames of latency, so input handling can be tested deterministically
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class ANTIGRAVITYTEST_API UInputBufferComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Max number of pending inputs. Once full, the oldest input is overwritten
+	static constexpr int32 Capacity = 16;
+
+	// Frame rate second-based tolerances are converted at, so an input window is the same number of frames at any frame rate
+	static constexpr float ReferenceFrameRate = 60.0f;
+
+	// Convert a tolerance in seconds to a max age in frames at the reference frame rate. Capped at an hour
+	static int32 SecondsToFrames(float Seconds) { return FMath::RoundToInt32(FMath::Min(Seconds, 3600.0f) * ReferenceFrameRate); }
+
+	UInputBufferComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Buffer an input the owner can't act on yet. Also records it
+	void BufferInput(EBufferedInputType Type);
+
+	// Record an input the owner acted on right away, without buffering it
+	void RecordInput(EBufferedInputType Type);
+
+	// Consume the oldest pending input matching TypeMask that arrived at most MaxAgeFrames frames ago.
+	// Older inputs that went stale are dropped. Returns false if there was nothing to consume
+	bool ConsumeInput(EBufferedInputType TypeMask, int32 MaxAgeFrames, EBufferedInputType* OutType = nullptr);
+
+	// Returns true if an input matching TypeMask that arrived at most MaxAgeFrames frames ago is pending
+	bool HasInput(EBufferedInputType TypeMask, int32 MaxAgeFrames) const;
+
+	// Drop pending inputs matching TypeMask
+	void ClearInputs(EBufferedInputType TypeMask);
+
+	// Get the number of pending inputs
+	int32 GetNumInputs() const { return Count; }
+
+	// Copy the pending inputs, oldest first
+	void SaveState(FInputBufferState& OutState) const;
+
+	// Replace the pending inputs with a saved state
+	void RestoreState(const FInputBufferState& State);
+
+	// Start recording every buffered and acted-on input
+	void StartRecording();
+
+	// Stop recording and return the recorded inputs, with frames relative to the start of the recording
+	TArray<FBufferedInput> StopRecording();
+
+	// Re-issue a recorded log through OnReplayInput, delayed by LatencyFrames
+	void StartReplay(const TArray<FBufferedInput>& Log, int32 LatencyFrames = 0);
+
+	// Stop replaying and drop the remaining replay inputs
+	void StopReplay();
+
+	// Returns true while a replay is in progress
+	bool IsReplaying() const { return ReplayIndex < ReplayLog.Num(); }
+
+	// Fired for every replayed input. Owners route it to the same handlers as live input
+	FOnBufferedInputReplayed OnReplayInput;
+
+private:
+	// Returns the ring index of the Nth oldest pending input
+	int32 GetRingIndex(int32 Offset) const { return (Head + Offset) % Capacity; }
+
+	// Removes the Nth oldest pending input, keeping the rest in order
+	void RemoveInputAt(int32 Offset);
+
+	// Pending inputs. Head is the oldest, followed by Count - 1 newer ones
+	TStaticArray<FBufferedInput, Capacity> Entries;
+	int32 Head = 0;
+	int32 Count = 0;
+
+	// Inputs recorded since StartRecording
+	TArray<FBufferedInput> RecordedLog;
+	uint64 RecordStartFrame = 0;
+	bool bRecording = false;
+
+	// Inputs being replayed, the next one to fire and the frame the replay started on
+	TArray<FBufferedInput> ReplayLog;
+	int32 ReplayIndex = 0;
+	int32 ReplayLatencyFrames = 0;
+	uint64 ReplayStartFrame = 0;
+};
@@ -1,68 +1,704 @@
 #include "InventoryComponent.h"
+#include "AntigravityTest.h"
+#include "Items/InventorySnapshot.h"
+#include "GameFramework/Actor.h"
+#include "Engine/AssetManager.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Net/UnrealNetwork.h"
+
+void FInventoryList::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
+{
+	if (OwnerComponent)
+	{
+		OwnerComponent->HandleReplicatedRemove(RemovedIndices);
+	}
+}
+
+void FInventoryList::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
+{
+	if (OwnerComponent)
+	{
+		OwnerComponent->HandleReplicatedAdd(AddedIndices);
+	}
+}
+
+void FInventoryList::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
+{
+	if (OwnerComponent)
+	{
+		OwnerComponent->HandleReplicatedChange(ChangedIndices);
+	}
+}
+
+void FInventoryList::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (OwnerComponent)
+	{
+		OwnerComponent->HandleReplicatedReceive();
+	}
+}
 
 UInventoryComponent::UInventoryComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+
+	Inventory.OwnerComponent = this;
+}
+
+void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UInventoryComponent, Inventory);
+}
+
+void UInventoryComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Items may have been serialized or edited directly, so make sure the index matches
+	RebuildItemIndices();
 }
 
 void UInventoryComponent::AddItem(UItemDefinition* ItemDef, int32 Quantity)
 {
-	if (!ItemDef || Quantity <= 0)
+	AddItemInternal(ItemDef, Quantity);
+	BroadcastChanges();
+}
+
+bool UInventoryComponent::RemoveItem(UItemDefinition* ItemDef, int32 Quantity)
+{
+	const bool bRemoved = RemoveItemInternal(ItemDef, Quantity);
+	BroadcastChanges();
+	return bRemoved;
+}
+
+void UInventoryComponent::AddItems(const TArray<FInventoryItem>& InItems)
+{
+	if (!CanModifyInventory())
 	{
 		return;
 	}
 
-	// Calculate check: Do we already have this item?
-	FInventoryItem* ExistingItem = Items.FindByPredicate([ItemDef](const FInventoryItem& Item)
+	Inventory.Items.Reserve(Inventory.Items.Num() + InItems.Num());
+	for (const FInventoryItem& Item : InItems)
 	{
-		return Item.ItemDef == ItemDef;
+		AddItemInternal(Item.ItemDef, Item.Quantity);
+	}
+
+	BroadcastChanges();
+}
+
+int32 UInventoryComponent::RemoveItems(const TArray<FInventoryItem>& InItems)
+{
+	if (!CanModifyInventory())
+	{
+		return 0;
+	}
+
+	int32 NumRemoved = 0;
+
+	for (const FInventoryItem& Item : InItems)
+	{
+		if (RemoveItemInternal(Item.ItemDef, Item.Quantity))
+		{
+			++NumRemoved;
+		}
+	}
+
+	BroadcastChanges();
+
+	return NumRemoved;
+}
+
+int32 UInventoryComponent::GetItemQuantity(const UItemDefinition* ItemDef) const
+{
+	const int32* Index = ItemIndices.Find(ItemDef);
+	return Index ? Inventory.Items[*Index].Quantity : 0;
+}
+
+int32 UInventoryComponent::GetQuantityWithTag(FGameplayTag Tag) const
+{
+	const FTagIndexEntry* Entry = TagIndex.Find(Tag);
+	return Entry ? Entry->Quantity : 0;
+}
+
+int32 UInventoryComponent::GetNumItemsWithTag(FGameplayTag Tag) const
+{
+	const FTagIndexEntry* Entry = TagIndex.Find(Tag);
+	return Entry ? Entry->ItemDefs.Num() : 0;
+}
+
+void UInventoryComponent::GetItemsWithTag(FGameplayTag Tag, TArray<FInventoryItem>& OutItems) const
+{
+	OutItems.Reset();
+
+	const FTagIndexEntry* Entry = TagIndex.Find(Tag);
+	if (!Entry)
+	{
+		return;
+	}
+
+	OutItems.Reserve(Entry->ItemDefs.Num());
+	for (const UItemDefinition* ItemDef : Entry->ItemDefs)
+	{
+		if (const int32* Index = ItemIndices.Find(ItemDef))
+		{
+			OutItems.Add(Inventory.Items[*Index]);
+		}
+	}
+}
+
+const TSet<const UItemDefinition*>* UInventoryComponent::FindItemDefinitionsWithTag(FGameplayTag Tag) const
+{
+	const FTagIndexEntry* Entry = TagIndex.Find(Tag);
+	return Entry ? &Entry->ItemDefs : nullptr;
+}
+
+void UInventoryComponent::CaptureSnapshot(FInventorySnapshot& OutSnapshot) const
+{
+	OutSnapshot.Entries.Reset(Inventory.Items.Num());
+
+	for (const FInventoryItem& Item : Inventory.Items)
+	{
+		const FPrimaryAssetId ItemId = Item.ItemDef ? Item.ItemDef->GetPrimaryAssetId() : FPrimaryAssetId();
+		if (!ItemId.IsValid())
+		{
+			UE_LOG(LogAntigravityTest, Warning, TEXT("%s: skipping %s in snapshot, it has no primary asset id"), *GetPathName(), *GetNameSafe(Item.ItemDef));
+			continue;
+		}
+
+		FInventorySnapshotEntry& Entry = OutSnapshot.Entries.AddDefaulted_GetRef();
+		Entry.ItemId = ItemId;
+		Entry.Quantity = Item.Quantity;
+	}
+}
+
+void UInventoryComponent::ApplySnapshot(const FInventorySnapshot& Snapshot, FOnInventorySnapshotComplete OnComplete)
+{
+	if (!CanModifyInventory() || !UAssetManager::IsInitialized())
+	{
+		OnComplete.ExecuteIfBound(false);
+		return;
+	}
+
+	// only definitions that are not resident yet need a load
+	UAssetManager& AssetManager = UAssetManager::Get();
+	TArray<FPrimaryAssetId> MissingIds;
+	for (const FInventorySnapshotEntry& Entry : Snapshot.Entries)
+	{
+		if (!AssetManager.GetPrimaryAssetObject<UItemDefinition>(Entry.ItemId))
+		{
+			MissingIds.AddUnique(Entry.ItemId);
+		}
+	}
+
+	if (MissingIds.IsEmpty())
+	{
+		OnComplete.ExecuteIfBound(ApplyResolvedSnapshot(Snapshot));
+		return;
+	}
+
+	TSharedRef<FInventorySnapshot> PendingSnapshot = MakeShared<FInventorySnapshot>(Snapshot);
+	TSharedPtr<FStreamableHandle> Handle = AssetManager.LoadPrimaryAssets(MissingIds, TArray<FName>(),
+		FStreamableDelegate::CreateWeakLambda(this, [this, PendingSnapshot, OnComplete]()
+		{
+			OnComplete.ExecuteIfBound(ApplyResolvedSnapshot(*PendingSnapshot));
+		}));
+
+	// nothing was started, e.g. every id was unknown to the asset manager. Unknown ids fail the apply below
+	if (!Handle.IsValid())
+	{
+		OnComplete.ExecuteIfBound(ApplyResolvedSnapshot(Snapshot));
+	}
+}
+
+void UInventoryComponent::SaveSnapshotAsync(const FString& FilePath, FOnInventorySnapshotComplete OnComplete)
+{
+	// capturing only copies ids and quantities, encoding and disk IO happen off the game thread
+	FInventorySnapshot Snapshot;
+	CaptureSnapshot(Snapshot);
+
+	Async(EAsyncExecution::ThreadPool, [Snapshot = MoveTemp(Snapshot), FilePath, OnComplete]()
+	{
+		TArray<uint8> Bytes;
+		Snapshot.Encode(Bytes);
+		const bool bSaved = FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+
+		AsyncTask(ENamedThreads::GameThread, [OnComplete, bSaved]()
+		{
+			OnComplete.ExecuteIfBound(bSaved);
+		});
+	});
+}
+
+void UInventoryComponent::LoadSnapshotAsync(const FString& FilePath, FOnInventorySnapshotComplete OnComplete)
+{
+	TWeakObjectPtr<UInventoryComponent> WeakThis(this);
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, FilePath, OnComplete]()
+	{
+		TArray<uint8> Bytes;
+		TSharedRef<FInventorySnapshot> Snapshot = MakeShared<FInventorySnapshot>();
+		const bool bDecoded = FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent) && Snapshot->Decode(Bytes);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Snapshot, OnComplete, bDecoded]()
+		{
+			UInventoryComponent* This = WeakThis.Get();
+			if (!This || !bDecoded)
+			{
+				OnComplete.ExecuteIfBound(false);
+				return;
+			}
+
+			This->ApplySnapshot(*Snapshot, OnComplete);
+		});
 	});
+}
+
+bool UInventoryComponent::CanModifyInventory() const
+{
+	const AActor* Owner = GetOwner();
+	if (Owner && !Owner->HasAuthority())
+	{
+		UE_LOG(LogAntigravityTest, Warning, TEXT("%s: inventory can only be modified on the server"), *GetPathName());
+		return false;
+	}
 
-	if (ExistingItem)
+	return true;
+}
+
+bool UInventoryComponent::AddItemInternal(UItemDefinition* ItemDef, int32 Quantity)
+{
+	if (!ItemDef || Quantity <= 0 || !CanModifyInventory())
 	{
-		ExistingItem->Quantity += Quantity;
+		return false;
 	}
-	else
+
+	// Do we already have this item?
+	if (const int32* Index = ItemIndices.Find(ItemDef))
 	{
-		FInventoryItem NewItem;
-		NewItem.ItemDef = ItemDef;
-		NewItem.Quantity = Quantity;
-		Items.Add(NewItem);
+		FInventoryItem& ExistingItem = Inventory.Items[*Index];
+		ExistingItem.Quantity += Quantity;
+		Inventory.MarkItemDirty(ExistingItem);
+		UpdateTagIndex(ItemDef, Quantity, 0);
+
+		FInventoryChange& Change = PendingChanges.Changes.AddDefaulted_GetRef();
+		Change.Type = EInventoryChangeType::QuantityChanged;
+		Change.Index = *Index;
+		Change.ItemDef = ItemDef;
+		Change.Quantity = ExistingItem.Quantity;
+		return true;
 	}
 
-	OnInventoryUpdated.Broadcast();
+	FInventoryItem NewItem;
+	NewItem.ItemDef = ItemDef;
+	NewItem.Quantity = Quantity;
+	const int32 NewIndex = Inventory.Items.Add(NewItem);
+	Inventory.MarkItemDirty(Inventory.Items[NewIndex]);
+	ItemIndices.Add(ItemDef, NewIndex);
+	UpdateTagIndex(ItemDef, Quantity, 1);
+
+	FInventoryChange& Change = PendingChanges.Changes.AddDefaulted_GetRef();
+	Change.Type = EInventoryChangeType::Added;
+	Change.Index = NewIndex;
+	Change.ItemDef = ItemDef;
+	Change.Quantity = Quantity;
+	return true;
 }
 
-bool UInventoryComponent::RemoveItem(UItemDefinition* ItemDef, int32 Quantity)
+bool UInventoryComponent::RemoveItemInternal(const UItemDefinition* ItemDef, int32 Quantity)
 {
-	if (!ItemDef || Quantity <= 0)
+	if (!ItemDef || Quantity <= 0 || !CanModifyInventory())
 	{
 		return false;
 	}
 
-	FInventoryItem* ExistingItem = Items.FindByPredicate([ItemDef](const FInventoryItem& Item)
+	const int32* Index = ItemIndices.Find(ItemDef);
+	if (!Index)
 	{
-		return Item.ItemDef == ItemDef;
-	});
+		return false;
+	}
+
+	FInventoryItem& ExistingItem = Inventory.Items[*Index];
+	if (ExistingItem.Quantity < Quantity)
+	{
+		return false;
+	}
+
+	ExistingItem.Quantity -= Quantity;
+	Inventory.MarkItemDirty(ExistingItem);
+	UpdateTagIndex(ItemDef, -Quantity, 0);
+
+	if (ExistingItem.Quantity == 0)
+	{
+		RemoveSlotAtSwap(*Index);
+		return true;
+	}
+
+	FInventoryChange& Change = PendingChanges.Changes.AddDefaulted_GetRef();
+	Change.Type = EInventoryChangeType::QuantityChanged;
+	Change.Index = *Index;
+	Change.ItemDef = ItemDef;
+	Change.Quantity = ExistingItem.Quantity;
+	return true;
+}
+
+void UInventoryComponent::RemoveSlotAtSwap(int32 Index)
+{
+	TArray<FInventoryItem>& Items = Inventory.Items;
+	const int32 LastIndex = Items.Num() - 1;
+
+	FInventoryChange& Change = PendingChanges.Changes.AddDefaulted_GetRef();
+	Change.Type = EInventoryChangeType::Removed;
+	Change.Index = Index;
+	Change.ItemDef = Items[Index].ItemDef;
+
+	// whatever quantity is left leaves the categories together with the slot
+	UpdateTagIndex(Items[Index].ItemDef, -Items[Index].Quantity, -1);
+	ExpandedCategories.Remove(Items[Index].ItemDef.Get());
+
+	ItemIndices.Remove(Items[Index].ItemDef.Get());
+
+	// The last slot moves into the hole, so its index entry has to follow it
+	if (Index != LastIndex)
+	{
+		ItemIndices.Add(Items[LastIndex].ItemDef.Get(), Index);
+		Change.MovedFromIndex = LastIndex;
+	}
+
+	Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	// removals are only picked up by a full array compare
+	Inventory.MarkArrayDirty();
+}
+
+bool UInventoryComponent::ApplyResolvedSnapshot(const FInventorySnapshot& Snapshot)
+{
+	if (!CanModifyInventory())
+	{
+		return false;
+	}
+
+	// resolve everything first, a snapshot that can't be fully applied must not wipe the inventory
+	UAssetManager& AssetManager = UAssetManager::Get();
+	TArray<UItemDefinition*> ItemDefs;
+	ItemDefs.Reserve(Snapshot.Entries.Num());
+
+	bool bResolved = true;
+	for (const FInventorySnapshotEntry& Entry : Snapshot.Entries)
+	{
+		UItemDefinition* ItemDef = AssetManager.GetPrimaryAssetObject<UItemDefinition>(Entry.ItemId);
+		if (!ItemDef)
+		{
+			UE_LOG(LogAntigravityTest, Warning, TEXT("%s: snapshot item %s could not be resolved"), *GetPathName(), *Entry.ItemId.ToString());
+			bResolved = false;
+		}
+
+		ItemDefs.Add(ItemDef);
+	}
+
+	if (!bResolved)
+	{
+		return false;
+	}
+
+	// drop from the back so no slot has to be swapped
+	for (int32 Index = Inventory.Items.Num() - 1; Index >= 0; --Index)
+	{
+		RemoveSlotAtSwap(Index);
+	}
+
+	Inventory.Items.Reserve(Snapshot.Entries.Num());
+	for (int32 EntryIndex = 0; EntryIndex < Snapshot.Entries.Num(); ++EntryIndex)
+	{
+		AddItemInternal(ItemDefs[EntryIndex], Snapshot.Entries[EntryIndex].Quantity);
+	}
+
+	BroadcastChanges();
+	return true;
+}
+
+void UInventoryComponent::BroadcastChanges()
+{
+	if (PendingChanges.IsEmpty())
+	{
+		return;
+	}
+
+	// Listeners may modify the inventory again, so hand them a detached copy
+	const FInventoryChangeSet ChangeSet = MoveTemp(PendingChanges);
+	PendingChanges = FInventoryChangeSet();
+
+	OnInventoryChanged.Broadcast(ChangeSet);
+	OnInventoryUpdated.Broadcast();
+}
+
+void UInventoryComponent::RebuildItemIndices()
+{
+	TArray<FInventoryItem>& Items = Inventory.Items;
+	ItemIndices.Reset();
+
+	// clients mirror the server's list as-is, fixing it up locally would only diverge
+	const AActor* Owner = GetOwner();
+	const bool bCanMergeSlots = !Owner || Owner->HasAuthority();
+	bool bMerged = false;
 
-	if (ExistingItem)
+	// Merge duplicate or empty slots that the index cannot represent
+	for (int32 Index = 0; Index < Items.Num();)
 	{
-		if (ExistingItem->Quantity >= Quantity)
+		const FInventoryItem& Item = Items[Index];
+		if (bCanMergeSlots && !Item.IsValid())
 		{
-			ExistingItem->Quantity -= Quantity;
-			
-			if (ExistingItem->Quantity == 0)
+			Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			bMerged = true;
+			continue;
+		}
+
+		if (const int32* ExistingIndex = ItemIndices.Find(Item.ItemDef.Get()))
+		{
+			if (bCanMergeSlots)
 			{
-				Items.RemoveAll([ItemDef](const FInventoryItem& Item)
-				{
-					return Item.ItemDef == ItemDef;
-				});
+				Items[*ExistingIndex].Quantity += Item.Quantity;
+				Inventory.MarkItemDirty(Items[*ExistingIndex]);
+				Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+				bMerged = true;
+				continue;
 			}
+		}
+		else if (Item.ItemDef)
+		{
+			ItemIndices.Add(Item.ItemDef.Get(), Index);
+		}
+
+		++Index;
+	}
+
+	if (bMerged)
+	{
+		Inventory.MarkArrayDirty();
+	}
+
+	RebuildTagIndex();
+}
+
+void UInventoryComponent::UpdateTagIndex(const UItemDefinition* ItemDef, int32 QuantityDelta, int32 EntryDelta)
+{
+	if (!ItemDef || ItemDef->Categories.IsEmpty())
+	{
+		return;
+	}
+
+	for (const FGameplayTag& Tag : GetExpandedCategories(ItemDef))
+	{
+		FTagIndexEntry& Entry = TagIndex.FindOrAdd(Tag);
+		Entry.Quantity += QuantityDelta;
 
-			OnInventoryUpdated.Broadcast();
-			return true;
+		if (EntryDelta > 0)
+		{
+			Entry.ItemDefs.Add(ItemDef);
+		}
+		else if (EntryDelta < 0)
+		{
+			Entry.ItemDefs.Remove(ItemDef);
+			if (Entry.ItemDefs.IsEmpty())
+			{
+				TagIndex.Remove(Tag);
+			}
 		}
 	}
+}
+
+const FGameplayTagContainer& UInventoryComponent::GetExpandedCategories(const UItemDefinition* ItemDef)
+{
+	if (const FGameplayTagContainer* Cached = ExpandedCategories.Find(ItemDef))
+	{
+		return *Cached;
+	}
+
+	return ExpandedCategories.Add(ItemDef, ItemDef->Categories.GetGameplayTagParents());
+}
+
+void UInventoryComponent::RebuildTagIndex()
+{
+	TagIndex.Reset();
+	ExpandedCategories.Reset();
+
+	for (int32 Index = 0; Index < Inventory.Items.Num(); ++Index)
+	{
+		// only the indexed slot of each definition counts, clients may briefly hold duplicates
+		FInventoryItem& Item = Inventory.Items[Index];
+		const int32* IndexedSlot = ItemIndices.Find(Item.ItemDef.Get());
+		if (IndexedSlot && *IndexedSlot == Index)
+		{
+			UpdateTagIndex(Item.ItemDef, Item.Quantity, 1);
+			Item.IndexedItemDef = Item.ItemDef;
+			Item.IndexedQuantity = Item.Quantity;
+		}
+		else
+		{
+			Item.IndexedItemDef = nullptr;
+			Item.IndexedQuantity = 0;
+		}
+	}
+}
+
+void UInventoryComponent::IndexReplicatedSlot(int32 Index)
+{
+	FInventoryItem& Item = Inventory.Items[Index];
+	if (!Item.ItemDef || ItemIndices.Contains(Item.ItemDef.Get()))
+	{
+		return;
+	}
+
+	ItemIndices.Add(Item.ItemDef.Get(), Index);
+	UpdateTagIndex(Item.ItemDef, Item.Quantity, 1);
+
+	Item.IndexedItemDef = Item.ItemDef;
+	Item.IndexedQuantity = Item.Quantity;
+}
+
+void UInventoryComponent::UnindexReplicatedSlot(int32 Index)
+{
+	FInventoryItem& Item = Inventory.Items[Index];
+	if (!Item.IndexedItemDef)
+	{
+		return;
+	}
+
+	UpdateTagIndex(Item.IndexedItemDef, -Item.IndexedQuantity, -1);
+	ExpandedCategories.Remove(Item.IndexedItemDef);
+	ItemIndices.Remove(Item.IndexedItemDef);
+
+	Item.IndexedItemDef = nullptr;
+	Item.IndexedQuantity = 0;
+}
+
+void UInventoryComponent::HandleReplicatedRemove(const TArrayView<int32> RemovedIndices)
+{
+	const TArray<FInventoryItem>& Items = Inventory.Items;
+
+	for (const int32 Index : RemovedIndices)
+	{
+		if (!Items.IsValidIndex(Index))
+		{
+			continue;
+		}
+
+		OnReplicatedItemRemoved.Broadcast(Items[Index], Index);
+
+		// the fast array removes these after adds and changes have been reported
+		PendingReplicatedRemovals.Emplace(Index, Items[Index].ItemDef.Get());
+
+		UnindexReplicatedSlot(Index);
+	}
+}
+
+void UInventoryComponent::HandleReplicatedAdd(const TArrayView<int32> AddedIndices)
+{
+	TArray<FInventoryItem>& Items = Inventory.Items;
+
+	for (const int32 Index : AddedIndices)
+	{
+		if (!Items.IsValidIndex(Index))
+		{
+			continue;
+		}
+
+		FInventoryItem& Item = Items[Index];
+
+		// new slots have contributed nothing yet
+		Item.IndexedItemDef = nullptr;
+		Item.IndexedQuantity = 0;
+		IndexReplicatedSlot(Index);
+
+		FInventoryChange& Change = PendingChanges.Changes.AddDefaulted_GetRef();
+		Change.Type = EInventoryChangeType::Added;
+		Change.Index = Index;
+		Change.ItemDef = Item.ItemDef;
+		Change.Quantity = Item.Quantity;
+
+		OnReplicatedItemAdded.Broadcast(Item, Index);
+	}
+}
+
+void UInventoryComponent::HandleReplicatedChange(const TArrayView<int32> ChangedIndices)
+{
+	TArray<FInventoryItem>& Items = Inventory.Items;
+
+	for (const int32 Index : ChangedIndices)
+	{
+		if (!Items.IsValidIndex(Index))
+		{
+			continue;
+		}
+
+		FInventoryItem& Item = Items[Index];
+
+		// apply the quantity delta to the slot's categories, or re-index it if it now holds another definition
+		if (Item.IndexedItemDef && Item.IndexedItemDef != Item.ItemDef)
+		{
+			UnindexReplicatedSlot(Index);
+		}
+
+		if (Item.IndexedItemDef)
+		{
+			UpdateTagIndex(Item.ItemDef, Item.Quantity - Item.IndexedQuantity, 0);
+			Item.IndexedQuantity = Item.Quantity;
+		}
+		else
+		{
+			IndexReplicatedSlot(Index);
+		}
+
+		FInventoryChange& Change = PendingChanges.Changes.AddDefaulted_GetRef();
+		Change.Type = EInventoryChangeType::QuantityChanged;
+		Change.Index = Index;
+		Change.ItemDef = Item.ItemDef;
+		Change.Quantity = Item.Quantity;
+
+		OnReplicatedItemChanged.Broadcast(Item, Index);
+	}
+}
+
+void UInventoryComponent::HandleReplicatedReceive()
+{
+	// The fast array swap-removes deleted entries from the highest index down, replay that order so
+	// listeners can mirror the list exactly
+	PendingReplicatedRemovals.Sort([](const TPair<int32, const UItemDefinition*>& A, const TPair<int32, const UItemDefinition*>& B)
+	{
+		return A.Key > B.Key;
+	});
+
+	int32 NumBeforeRemoval = Inventory.Items.Num() + PendingReplicatedRemovals.Num();
+	for (const TPair<int32, const UItemDefinition*>& Removal : PendingReplicatedRemovals)
+	{
+		const int32 LastIndex = NumBeforeRemoval - 1;
+
+		FInventoryChange& Change = PendingChanges.Changes.AddDefaulted_GetRef();
+		Change.Type = EInventoryChangeType::Removed;
+		Change.Index = Removal.Key;
+		Change.MovedFromIndex = Removal.Key != LastIndex ? LastIndex : INDEX_NONE;
+		Change.ItemDef = Removal.Value;
+
+		--NumBeforeRemoval;
+	}
+
+	// The fast array has already swapped survivors into the holes, so point their index entries at their new slots
+	for (const TPair<int32, const UItemDefinition*>& Removal : PendingReplicatedRemovals)
+	{
+		if (Inventory.Items.IsValidIndex(Removal.Key))
+		{
+			if (const UItemDefinition* MovedItemDef = Inventory.Items[Removal.Key].IndexedItemDef)
+			{
+				ItemIndices.Add(MovedItemDef, Removal.Key);
+			}
+		}
+	}
+
+	PendingReplicatedRemovals.Reset();
 
-	return false;
+	BroadcastChanges();
 }
@@ -3,9 +3,15 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Items/InventoryTypes.h"
+#include "GameplayTagContainer.h"
 #include "InventoryComponent.generated.h"
 
+struct FInventorySnapshot;
+
 DECLARE_MULTICAST_DELEGATE(FOnInventoryUpdated);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnInventoryChanged, const FInventoryChangeSet&);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInventoryItemReplicated, const FInventoryItem& /*Item*/, int32 /*Index*/);
+DECLARE_DELEGATE_OneParam(FOnInventorySnapshotComplete, bool /*bSuccess*/);
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class ANTIGRAVITYTEST_API UInventoryComponent : public UActorComponent
@@ -16,21 +22,141 @@ public:
 	// Sets default values for this component's properties
 	UInventoryComponent();
 
-	// Add an item to the inventory
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Add an item to the inventory. Server only
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	void AddItem(UItemDefinition* ItemDef, int32 Quantity = 1);
 
-	// Remove an item from the inventory
+	// Remove an item from the inventory. Server only
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	bool RemoveItem(UItemDefinition* ItemDef, int32 Quantity = 1);
 
-	// Get all items (const reference)
-	const TArray<FInventoryItem>& GetItems() const { return Items; }
+	// Add several items at once, broadcasting a single update
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void AddItems(const TArray<FInventoryItem>& InItems);
+
+	// Remove several items at once, broadcasting a single update. Returns the number of entries that were removed
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	int32 RemoveItems(const TArray<FInventoryItem>& InItems);
+
+	// Get the quantity held of an item definition
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	int32 GetItemQuantity(const UItemDefinition* ItemDef) const;
+
+	// Get the total quantity of items in a category, including sub-categories. O(1)
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	int32 GetQuantityWithTag(FGameplayTag Tag) const;
+
+	// Get the number of distinct items in a category, including sub-categories. O(1)
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+	int32 GetNumItemsWithTag(FGameplayTag Tag) const;
+
+	// Get the items in a category, including sub-categories, without scanning the inventory
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void GetItemsWithTag(FGameplayTag Tag, TArray<FInventoryItem>& OutItems) const;
+
+	// Get the item definitions held in a category without copying, or nullptr if there are none
+	const TSet<const UItemDefinition*>* FindItemDefinitionsWithTag(FGameplayTag Tag) const;
+
+	// Get all items (const reference). Order is not stable across removals
+	const TArray<FInventoryItem>& GetItems() const { return Inventory.Items; }
+
+	// Capture the inventory as a snapshot. Items without a valid primary asset id are skipped
+	void CaptureSnapshot(FInventorySnapshot& OutSnapshot) const;
+
+	// Replace the inventory with a snapshot, loading item definitions that are not resident yet. Server only.
+	// If any item can't be resolved the inventory is left unchanged and OnComplete reports false
+	void ApplySnapshot(const FInventorySnapshot& Snapshot, FOnInventorySnapshotComplete OnComplete = FOnInventorySnapshotComplete());
+
+	// Capture the inventory, then encode and write it to FilePath on a worker thread
+	void SaveSnapshotAsync(const FString& FilePath, FOnInventorySnapshotComplete OnComplete = FOnInventorySnapshotComplete());
+
+	// Read and decode FilePath on a worker thread, then apply it on the game thread. Server only
+	void LoadSnapshotAsync(const FString& FilePath, FOnInventorySnapshotComplete OnComplete = FOnInventorySnapshotComplete());
 
 	// Delegate fired when inventory changes
 	FOnInventoryUpdated OnInventoryUpdated;
 
+	// Delegate fired alongside OnInventoryUpdated with the slots that changed
+	FOnInventoryChanged OnInventoryChanged;
+
+	// Client-side delegates fired per entry as replicated changes arrive, before OnInventoryChanged
+	FOnInventoryItemReplicated OnReplicatedItemAdded;
+	FOnInventoryItemReplicated OnReplicatedItemChanged;
+	FOnInventoryItemReplicated OnReplicatedItemRemoved;
+
 protected:
-	UPROPERTY(VisibleAnywhere, Category = "Inventory")
-	TArray<FInventoryItem> Items;
+	virtual void OnRegister() override;
+
+	UPROPERTY(VisibleAnywhere, Replicated, Category = "Inventory")
+	FInventoryList Inventory;
+
+private:
+	friend struct FInventoryList;
+
+	// Returns false (and warns) when called on a client, which would diverge from the replicated list
+	bool CanModifyInventory() const;
+
+	// Applies an add without broadcasting. Returns true if the inventory changed
+	bool AddItemInternal(UItemDefinition* ItemDef, int32 Quantity);
+
+	// Applies a removal without broadcasting. Returns true if the inventory changed
+	bool RemoveItemInternal(const UItemDefinition* ItemDef, int32 Quantity);
+
+	// Removes the slot at Index by swapping the last slot into it
+	void RemoveSlotAtSwap(int32 Index);
+
+	// Applies a quantity change of an item to every category it belongs to. EntryDelta is +1/-1 when the item enters/leaves the inventory
+	void UpdateTagIndex(const UItemDefinition* ItemDef, int32 QuantityDelta, int32 EntryDelta);
+
+	// Returns the item's categories expanded with their parents, cached while the item is held
+	const FGameplayTagContainer& GetExpandedCategories(const UItemDefinition* ItemDef);
+
+	// Rebuilds TagIndex from Items
+	void RebuildTagIndex();
+
+	// Replaces all items with the snapshot entries and broadcasts once.
+	// Returns false without touching the items if any entry can't be resolved to a loaded definition
+	bool ApplyResolvedSnapshot(const FInventorySnapshot& Snapshot);
+
+	// Broadcasts and clears PendingChanges, if any
+	void BroadcastChanges();
+
+	// Rebuilds ItemIndices from Items, e.g. after Items was loaded or edited
+	void RebuildItemIndices();
+
+	// Indexes a replicated slot, unless another slot already holds its definition
+	void IndexReplicatedSlot(int32 Index);
+
+	// Drops whatever a replicated slot contributed to the indices
+	void UnindexReplicatedSlot(int32 Index);
+
+	// Replication callbacks forwarded from Inventory on clients
+	void HandleReplicatedRemove(const TArrayView<int32> RemovedIndices);
+	void HandleReplicatedAdd(const TArrayView<int32> AddedIndices);
+	void HandleReplicatedChange(const TArrayView<int32> ChangedIndices);
+	void HandleReplicatedReceive();
+
+	// Maps each held item definition to its slot in Items. Items keeps the definitions referenced
+	TMap<const UItemDefinition*, int32> ItemIndices;
+
+	// Changes applied since the last broadcast
+	FInventoryChangeSet PendingChanges;
+
+	// Running totals and members of one category
+	struct FTagIndexEntry
+	{
+		int32 Quantity = 0;
+		TSet<const UItemDefinition*> ItemDefs;
+	};
+
+	// Per-category totals, kept up to date as items change
+	TMap<FGameplayTag, FTagIndexEntry> TagIndex;
+
+	// Categories of held items including parent tags, so updates do not have to walk the tag tree
+	TMap<const UItemDefinition*, FGameplayTagContainer> ExpandedCategories;
+
+	// Entries announced as removed during the current replication update, applied by the fast array afterwards
+	TArray<TPair<int32, const UItemDefinition*>> PendingReplicatedRemovals;
 };
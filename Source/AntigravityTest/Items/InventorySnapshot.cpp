@@ -0,0 +1,207 @@
+#include "InventorySnapshot.h"
+
+namespace InventorySnapshot
+{
+	static void WriteVarUInt(TArray<uint8>& Bytes, uint64 Value)
+	{
+		do
+		{
+			uint8 Byte = Value & 0x7F;
+			Value >>= 7;
+			if (Value != 0)
+			{
+				Byte |= 0x80;
+			}
+			Bytes.Add(Byte);
+		}
+		while (Value != 0);
+	}
+
+	/** Bounds-checked reader over an encoded snapshot */
+	struct FReader
+	{
+		const TArray<uint8>& Bytes;
+		int32 Offset = 0;
+		bool bError = false;
+
+		explicit FReader(const TArray<uint8>& InBytes) : Bytes(InBytes) {}
+
+		uint64 ReadVarUInt()
+		{
+			uint64 Value = 0;
+			for (int32 Shift = 0; Shift < 64; Shift += 7)
+			{
+				if (Offset >= Bytes.Num())
+				{
+					bError = true;
+					return 0;
+				}
+
+				const uint8 Byte = Bytes[Offset++];
+				Value |= uint64(Byte & 0x7F) << Shift;
+				if ((Byte & 0x80) == 0)
+				{
+					return Value;
+				}
+			}
+
+			bError = true;
+			return 0;
+		}
+
+		template<typename T>
+		T ReadFixed()
+		{
+			T Value = 0;
+			if (Offset + int32(sizeof(T)) > Bytes.Num())
+			{
+				bError = true;
+				return Value;
+			}
+
+			// the format is little endian regardless of platform
+			for (int32 Index = 0; Index < int32(sizeof(T)); ++Index)
+			{
+				Value |= T(Bytes[Offset++]) << (Index * 8);
+			}
+			return Value;
+		}
+
+		const uint8* ReadBytes(int32 Num)
+		{
+			if (Num < 0 || Offset + Num > Bytes.Num())
+			{
+				bError = true;
+				return nullptr;
+			}
+
+			const uint8* Data = Bytes.GetData() + Offset;
+			Offset += Num;
+			return Data;
+		}
+	};
+
+	template<typename T>
+	static void WriteFixed(TArray<uint8>& Bytes, T Value)
+	{
+		for (int32 Index = 0; Index < int32(sizeof(T)); ++Index)
+		{
+			Bytes.Add(uint8(Value >> (Index * 8)));
+		}
+	}
+}
+
+void FInventorySnapshot::Encode(TArray<uint8>& OutBytes) const
+{
+	using namespace InventorySnapshot;
+
+	// build the shared name table, types repeat across almost every entry
+	TMap<FName, int32> NameIndices;
+	TArray<FName> Names;
+	TArray<TPair<int32, int32>> EntryNames;
+	EntryNames.Reserve(Entries.Num());
+
+	auto GetNameIndex = [&NameIndices, &Names](FName Name)
+	{
+		if (const int32* Existing = NameIndices.Find(Name))
+		{
+			return *Existing;
+		}
+
+		const int32 NewIndex = Names.Add(Name);
+		NameIndices.Add(Name, NewIndex);
+		return NewIndex;
+	};
+
+	for (const FInventorySnapshotEntry& Entry : Entries)
+	{
+		EntryNames.Emplace(GetNameIndex(Entry.ItemId.PrimaryAssetType.GetName()), GetNameIndex(Entry.ItemId.PrimaryAssetName));
+	}
+
+	OutBytes.Reset();
+	OutBytes.Reserve(16 + Names.Num() * 24 + Entries.Num() * 4);
+
+	WriteFixed<uint32>(OutBytes, Magic);
+	WriteFixed<uint16>(OutBytes, uint16(EVersion::Latest));
+
+	WriteVarUInt(OutBytes, Names.Num());
+	for (const FName& Name : Names)
+	{
+		const FTCHARToUTF8 Utf8(*Name.ToString());
+		WriteVarUInt(OutBytes, Utf8.Length());
+		OutBytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	WriteVarUInt(OutBytes, Entries.Num());
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		WriteVarUInt(OutBytes, EntryNames[Index].Key);
+		WriteVarUInt(OutBytes, EntryNames[Index].Value);
+		WriteVarUInt(OutBytes, uint32(FMath::Max(0, Entries[Index].Quantity)));
+	}
+}
+
+bool FInventorySnapshot::Decode(const TArray<uint8>& Bytes)
+{
+	using namespace InventorySnapshot;
+
+	Entries.Reset();
+
+	FReader Reader(Bytes);
+	if (Reader.ReadFixed<uint32>() != Magic)
+	{
+		return false;
+	}
+
+	const uint16 Version = Reader.ReadFixed<uint16>();
+	if (Reader.bError || Version < uint16(EVersion::Initial) || Version > uint16(EVersion::Latest))
+	{
+		return false;
+	}
+
+	const uint64 NameCount = Reader.ReadVarUInt();
+	if (Reader.bError || NameCount > uint64(Bytes.Num()))
+	{
+		return false;
+	}
+
+	TArray<FName> Names;
+	Names.Reserve(int32(NameCount));
+	for (uint64 Index = 0; Index < NameCount; ++Index)
+	{
+		const int32 Length = int32(FMath::Min<uint64>(Reader.ReadVarUInt(), MAX_int32));
+		const uint8* Data = Reader.ReadBytes(Length);
+		if (Reader.bError)
+		{
+			return false;
+		}
+
+		const auto Converted = StringCast<TCHAR>(reinterpret_cast<const UTF8CHAR*>(Data), Length);
+		Names.Add(FName(Converted.Length(), Converted.Get()));
+	}
+
+	const uint64 EntryCount = Reader.ReadVarUInt();
+	if (Reader.bError || EntryCount > uint64(Bytes.Num()))
+	{
+		return false;
+	}
+
+	Entries.Reserve(int32(EntryCount));
+	for (uint64 Index = 0; Index < EntryCount; ++Index)
+	{
+		const uint64 TypeIndex = Reader.ReadVarUInt();
+		const uint64 NameIndex = Reader.ReadVarUInt();
+		const uint64 Quantity = Reader.ReadVarUInt();
+		if (Reader.bError || TypeIndex >= uint64(Names.Num()) || NameIndex >= uint64(Names.Num()) || Quantity > uint64(MAX_int32))
+		{
+			Entries.Reset();
+			return false;
+		}
+
+		FInventorySnapshotEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.ItemId = FPrimaryAssetId(FPrimaryAssetType(Names[int32(TypeIndex)]), Names[int32(NameIndex)]);
+		Entry.Quantity = int32(Quantity);
+	}
+
+	return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/PrimaryAssetId.h"
+
+/**
+ * A single saved inventory entry
+ */
+struct FInventorySnapshotEntry
+{
+	FPrimaryAssetId ItemId;
+	int32 Quantity = 0;
+};
+
+/**
+ * Compact binary snapshot of an inventory.
+ *
+ * Layout (all integers after the fixed header are unsigned LEB128 varints):
+ *   uint32 Magic, uint16 Version
+ *   NameCount, then NameCount x (ByteLength, UTF-8 bytes)
+ *   EntryCount, then EntryCount x (TypeNameIndex, AssetNameIndex, Quantity)
+ *
+ * Item definitions are stored as primary asset ids through a shared name table, so a save
+ * never contains object paths and repeated asset types cost one or two bytes per entry.
+ * Encoding and decoding do not touch UObjects and are safe to run on a worker thread.
+ */
+struct ANTIGRAVITYTEST_API FInventorySnapshot
+{
+	static constexpr uint32 Magic = 0x53564E49; // "INVS"
+
+	enum class EVersion : uint16
+	{
+		Initial = 1,
+
+		// -----<new versions can be added above this line>-----
+		VersionPlusOne,
+		Latest = VersionPlusOne - 1
+	};
+
+	TArray<FInventorySnapshotEntry> Entries;
+
+	/** Encodes the snapshot, replacing the contents of OutBytes */
+	void Encode(TArray<uint8>& OutBytes) const;
+
+	/** Decodes a snapshot written by any known version. Returns false on malformed or newer data */
+	bool Decode(const TArray<uint8>& Bytes);
+};
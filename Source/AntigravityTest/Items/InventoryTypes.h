@@ -2,13 +2,16 @@
 
 #include "CoreMinimal.h"
 #include "ItemDefinition.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "InventoryTypes.generated.h"
 
+class UInventoryComponent;
+
 /**
  * Represents a specific instance of an item in an inventory (Item Definition + Quantity)
  */
 USTRUCT(BlueprintType)
-struct FInventoryItem
+struct FInventoryItem : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 
@@ -18,6 +21,11 @@ struct FInventoryItem
 	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
 	int32 Quantity = 0;
 
+	// Client-side bookkeeping, never replicated: the definition and quantity this slot last contributed to the
+	// owner's indices, so replicated changes can be applied as deltas
+	const UItemDefinition* IndexedItemDef = nullptr;
+	int32 IndexedQuantity = 0;
+
 	bool IsValid() const
 	{
 		return ItemDef != nullptr && Quantity > 0;
@@ -28,3 +36,83 @@ struct FInventoryItem
 		return ItemDef == Other.ItemDef;
 	}
 };
+
+/**
+ * Replicated container of inventory items. Only entries marked dirty are sent, and the owning
+ * component is notified per entry on clients.
+ */
+USTRUCT()
+struct FInventoryList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Inventory")
+	TArray<FInventoryItem> Items;
+
+	/** Component that owns this list and receives the replication callbacks */
+	UPROPERTY(NotReplicated, Transient)
+	TObjectPtr<UInventoryComponent> OwnerComponent = nullptr;
+
+	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
+	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FInventoryItem, FInventoryList>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FInventoryList> : public TStructOpsTypeTraitsBase2<FInventoryList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Kind of change applied to a single inventory slot
+ */
+enum class EInventoryChangeType : uint8
+{
+	Added,
+	Removed,
+	QuantityChanged
+};
+
+/**
+ * A single slot change. Indices refer to the inventory as it was when the change was applied,
+ * so a change set has to be replayed in order.
+ */
+struct FInventoryChange
+{
+	EInventoryChangeType Type = EInventoryChangeType::Added;
+
+	/** Slot the change applies to. Added slots are always appended */
+	int32 Index = INDEX_NONE;
+
+	/** For Removed: the last slot that was swapped into Index, or INDEX_NONE if Index was the last slot */
+	int32 MovedFromIndex = INDEX_NONE;
+
+	/** Item held by the slot before a removal, or after any other change */
+	const UItemDefinition* ItemDef = nullptr;
+
+	/** Quantity after the change, 0 for removals */
+	int32 Quantity = 0;
+};
+
+/**
+ * Ordered list of slot changes produced by one inventory operation or batch
+ */
+struct FInventoryChangeSet
+{
+	TArray<FInventoryChange> Changes;
+
+	bool IsEmpty() const
+	{
+		return Changes.IsEmpty();
+	}
+};
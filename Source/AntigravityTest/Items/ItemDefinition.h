@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
 #include "ItemDefinition.generated.h"
 
 /**
@@ -21,7 +22,11 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item", meta = (MultiLine = true))
 	FText Description;
 
-	// Icon to display in UI
+	// Categories used by inventory queries. Parent tags match too, e.g. Item.Consumable matches Item.Consumable.Healing
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item")
-	TObjectPtr<UTexture2D> Icon;
+	FGameplayTagContainer Categories;
+
+	// Icon to display in UI. Soft so loading a definition does not pull in its texture, the UI streams it on demand
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item")
+	TSoftObjectPtr<UTexture2D> Icon;
 };
@@ -0,0 +1,371 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "AntigravityTest/Variant_Combat/CombatCharacter.h"
+#include "AntigravityTest/Variant_Combat/AI/CombatEnemy.h"
+#include "AntigravityTest/Variant_Combat/Gameplay/CombatSceneQueryCounter.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CombatBenchmark
+{
+	// Assets the benchmark arena is built from
+	const TCHAR* EnemyClassPath = TEXT("/Game/Variant_Combat/Blueprints/AI/BP_CombatEnemy.BP_CombatEnemy_C");
+	const TCHAR* BotClassPath = TEXT("/Game/Variant_Combat/Blueprints/BP_CombatCharacter.BP_CombatCharacter_C");
+	const TCHAR* FloorMeshPath = TEXT("/Engine/BasicShapes/Cube.Cube");
+
+	// Fixed step and run length. Warmup frames let spawning and AI startup settle and aren't recorded
+	constexpr float FixedDeltaTime = 1.0f / 60.0f;
+	constexpr int32 WarmupFrames = 60;
+	constexpr int32 RecordedFrames = 600;
+	constexpr int32 RandomSeed = 1337;
+
+	struct FFrameSample
+	{
+		double GameThreadMs = 0.0;
+		uint64 SceneQueries = 0;
+		int32 Spawns = 0;
+		int32 Destroys = 0;
+	};
+
+	struct FRunSummary
+	{
+		int32 NumEnemies = 0;
+		double AvgGameThreadMs = 0.0;
+		double P95GameThreadMs = 0.0;
+		double MaxGameThreadMs = 0.0;
+		double AvgSceneQueries = 0.0;
+		uint64 MaxSceneQueries = 0;
+		int32 Spawns = 0;
+		int32 Destroys = 0;
+	};
+
+	// Drives the bot's attack inputs from the frame number alone, so every run presses the same buttons on the same frames
+	void DriveBot(ACombatCharacter* Bot, int32 Frame)
+	{
+		// Turn slowly so attacks sweep through the whole ring of enemies
+		Bot->SetActorRotation(FRotator(0.0f, Frame * 1.5f, 0.0f));
+
+		switch (Frame % 240)
+		{
+		case 0:
+		case 20:
+		case 40:
+			Bot->DoComboAttackStart();
+			break;
+		case 5:
+		case 25:
+		case 45:
+			Bot->DoComboAttackEnd();
+			break;
+		case 120:
+			Bot->DoChargedAttackStart();
+			break;
+		case 180:
+			Bot->DoChargedAttackEnd();
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Places enemies on a sunflower spiral around the bot so density stays even as the count grows
+	FVector GetEnemyLocation(int32 EnemyIndex)
+	{
+		const float GoldenAngle = PI * (3.0f - FMath::Sqrt(5.0f));
+		const float Radius = 250.0f + 60.0f * FMath::Sqrt(float(EnemyIndex));
+		const float Angle = EnemyIndex * GoldenAngle;
+		return FVector(Radius * FMath::Cos(Angle), Radius * FMath::Sin(Angle), 100.0f);
+	}
+
+	bool RunScenario(FAutomationTestBase& Test, UClass* EnemyClass, UClass* BotClass, UStaticMesh* FloorMesh, int32 NumEnemies, TArray<FFrameSample>& OutSamples)
+	{
+		// A standalone game instance owns the world and its context, which setting the game mode needs
+		UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+		GameInstance->AddToRoot();
+		GameInstance->InitializeStandalone(FName(*FString::Printf(TEXT("CombatBenchmark_%d"), NumEnemies)));
+
+		UWorld* World = GameInstance->GetWorld();
+		if (!World)
+		{
+			Test.AddError(TEXT("Failed to create World"));
+			GameInstance->RemoveFromRoot();
+			return false;
+		}
+
+		auto DestroyScenarioWorld = [GameInstance, World]()
+		{
+			GameInstance->Shutdown();
+			GameInstance->RemoveFromRoot();
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		};
+
+		// Set a game mode so actors begin play as they spawn
+		const FURL URL;
+		World->SetGameMode(URL);
+		World->InitializeActorsForPlay(URL);
+		World->BeginPlay();
+
+		// Count spawns and destroys as they happen
+		int32 FrameSpawns = 0;
+		int32 FrameDestroys = 0;
+		const FDelegateHandle SpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateLambda([&FrameSpawns](AActor*) { ++FrameSpawns; }));
+		const FDelegateHandle DestroyedHandle = World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateLambda([&FrameDestroys](AActor*) { ++FrameDestroys; }));
+
+		// Floor
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>(FVector(0.0f, 0.0f, -50.0f), FRotator::ZeroRotator, SpawnParams);
+		Floor->SetMobility(EComponentMobility::Movable);
+		Floor->GetStaticMeshComponent()->SetStaticMesh(FloorMesh);
+		Floor->SetActorScale3D(FVector(200.0f, 200.0f, 1.0f));
+
+		// Bot, possessed by a player controller so enemy AI treats it as the player
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		ACombatCharacter* Bot = World->SpawnActor<ACombatCharacter>(BotClass, FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator, SpawnParams);
+		APlayerController* BotController = World->SpawnActor<APlayerController>();
+		if (!Bot || !BotController)
+		{
+			Test.AddError(TEXT("Failed to spawn the bot"));
+			World->RemoveOnActorSpawnedHandler(SpawnedHandle);
+			World->RemoveOnActorDestroyedHandler(DestroyedHandle);
+			DestroyScenarioWorld();
+			return false;
+		}
+		BotController->Possess(Bot);
+
+		// Enemies
+		for (int32 EnemyIndex = 0; EnemyIndex < NumEnemies; ++EnemyIndex)
+		{
+			const FVector Location = GetEnemyLocation(EnemyIndex);
+			const FRotator FacingBot = (-Location).GetSafeNormal2D().Rotation();
+			World->SpawnActor<ACombatEnemy>(EnemyClass, Location, FacingBot, SpawnParams);
+		}
+
+		// Step the world at a fixed rate
+		OutSamples.Reset(RecordedFrames);
+
+		for (int32 Frame = 0; Frame < WarmupFrames + RecordedFrames; ++Frame)
+		{
+			FrameSpawns = 0;
+			FrameDestroys = 0;
+			const uint64 QueriesBefore = GCombatSceneQueryCount;
+
+			if (IsValid(Bot))
+			{
+				DriveBot(Bot, Frame);
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			World->Tick(LEVELTICK_All, FixedDeltaTime);
+			const double GameThreadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			// Per-frame caches are keyed on the frame counter, which the engine loop normally advances
+			++GFrameCounter;
+
+			if (Frame >= WarmupFrames)
+			{
+				FFrameSample& Sample = OutSamples.AddDefaulted_GetRef();
+				Sample.GameThreadMs = GameThreadMs;
+				Sample.SceneQueries = GCombatSceneQueryCount - QueriesBefore;
+				Sample.Spawns = FrameSpawns;
+				Sample.Destroys = FrameDestroys;
+			}
+		}
+
+		// Clean up
+		World->RemoveOnActorSpawnedHandler(SpawnedHandle);
+		World->RemoveOnActorDestroyedHandler(DestroyedHandle);
+		DestroyScenarioWorld();
+
+		return true;
+	}
+
+	FRunSummary Summarize(int32 NumEnemies, const TArray<FFrameSample>& Samples)
+	{
+		FRunSummary Summary;
+		Summary.NumEnemies = NumEnemies;
+
+		if (Samples.IsEmpty())
+		{
+			return Summary;
+		}
+
+		TArray<double> FrameTimes;
+		FrameTimes.Reserve(Samples.Num());
+
+		uint64 TotalQueries = 0;
+		for (const FFrameSample& Sample : Samples)
+		{
+			FrameTimes.Add(Sample.GameThreadMs);
+			Summary.AvgGameThreadMs += Sample.GameThreadMs;
+			Summary.MaxGameThreadMs = FMath::Max(Summary.MaxGameThreadMs, Sample.GameThreadMs);
+			TotalQueries += Sample.SceneQueries;
+			Summary.MaxSceneQueries = FMath::Max(Summary.MaxSceneQueries, Sample.SceneQueries);
+			Summary.Spawns += Sample.Spawns;
+			Summary.Destroys += Sample.Destroys;
+		}
+
+		FrameTimes.Sort();
+		Summary.AvgGameThreadMs /= Samples.Num();
+		Summary.P95GameThreadMs = FrameTimes[FMath::Min(FrameTimes.Num() - 1, FMath::FloorToInt(FrameTimes.Num() * 0.95))];
+		Summary.AvgSceneQueries = double(TotalQueries) / Samples.Num();
+
+		return Summary;
+	}
+
+	// Reads "Enemies,AvgGameThreadMs,..." rows from a previous summary, keyed by enemy count
+	TMap<int32, double> LoadBaseline(const FString& FilePath)
+	{
+		TMap<int32, double> Baseline;
+
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+		{
+			return Baseline;
+		}
+
+		for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+		{
+			TArray<FString> Columns;
+			Lines[LineIndex].ParseIntoArray(Columns, TEXT(","));
+			if (Columns.Num() >= 2)
+			{
+				Baseline.Add(FCString::Atoi(*Columns[0]), FCString::Atod(*Columns[1]));
+			}
+		}
+
+		return Baseline;
+	}
+}
+
+/**
+ * Headless combat benchmark. Run with:
+ *   UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests AntigravityTest.Combat.Benchmark;Quit"
+ * Optional switches:
+ *   -CombatBenchmarkCounts=10,50,100       enemy counts to run, default 10,25,50,100,250,500
+ *   -CombatBenchmarkBaseline=<summary.csv> previous summary to compare against
+ *   -CombatBenchmarkTolerance=1.2          allowed ratio of average frame time over the baseline
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatBenchmarkTest, "AntigravityTest.Combat.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FCombatBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace CombatBenchmark;
+
+	UClass* EnemyClass = LoadClass<ACombatEnemy>(nullptr, EnemyClassPath);
+	UClass* BotClass = LoadClass<ACombatCharacter>(nullptr, BotClassPath);
+	UStaticMesh* FloorMesh = LoadObject<UStaticMesh>(nullptr, FloorMeshPath);
+	if (!EnemyClass || !BotClass || !FloorMesh)
+	{
+		AddError(TEXT("Failed to load the combat benchmark assets"));
+		return false;
+	}
+
+	// Enemy counts to run
+	TArray<int32> EnemyCounts = { 10, 25, 50, 100, 250, 500 };
+	FString CountsParam;
+	if (FParse::Value(FCommandLine::Get(), TEXT("CombatBenchmarkCounts="), CountsParam, false))
+	{
+		TArray<FString> Counts;
+		CountsParam.ParseIntoArray(Counts, TEXT(","));
+
+		EnemyCounts.Reset();
+		for (const FString& Count : Counts)
+		{
+			EnemyCounts.Add(FMath::Max(0, FCString::Atoi(*Count)));
+		}
+	}
+
+	// Fixed timestep and seeded randomness so runs are comparable
+	const bool bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	const double PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(FixedDeltaTime);
+
+	FString FramesCsv = TEXT("Enemies,Frame,GameThreadMs,SceneQueries,Spawns,Destroys\n");
+	FString SummaryCsv = TEXT("Enemies,AvgGameThreadMs,P95GameThreadMs,MaxGameThreadMs,AvgSceneQueries,MaxSceneQueries,Spawns,Destroys\n");
+	TArray<FRunSummary> Summaries;
+
+	for (const int32 NumEnemies : EnemyCounts)
+	{
+		FMath::RandInit(RandomSeed);
+
+		TArray<FFrameSample> Samples;
+		if (!RunScenario(*this, EnemyClass, BotClass, FloorMesh, NumEnemies, Samples))
+		{
+			break;
+		}
+
+		for (int32 Frame = 0; Frame < Samples.Num(); ++Frame)
+		{
+			const FFrameSample& Sample = Samples[Frame];
+			FramesCsv += FString::Printf(TEXT("%d,%d,%.4f,%llu,%d,%d\n"), NumEnemies, Frame, Sample.GameThreadMs, Sample.SceneQueries, Sample.Spawns, Sample.Destroys);
+		}
+
+		const FRunSummary& Summary = Summaries.Add_GetRef(Summarize(NumEnemies, Samples));
+		SummaryCsv += FString::Printf(TEXT("%d,%.4f,%.4f,%.4f,%.2f,%llu,%d,%d\n"), Summary.NumEnemies, Summary.AvgGameThreadMs, Summary.P95GameThreadMs,
+			Summary.MaxGameThreadMs, Summary.AvgSceneQueries, Summary.MaxSceneQueries, Summary.Spawns, Summary.Destroys);
+
+		const FString Line = FString::Printf(TEXT("%d enemies: avg %.2f ms, p95 %.2f ms, max %.2f ms, %.1f scene queries/frame, %d spawns, %d destroys"),
+			Summary.NumEnemies, Summary.AvgGameThreadMs, Summary.P95GameThreadMs, Summary.MaxGameThreadMs, Summary.AvgSceneQueries, Summary.Spawns, Summary.Destroys);
+		AddInfo(Line);
+		UE_LOG(LogTemp, Display, TEXT("[CombatBenchmark] %s"), *Line);
+	}
+
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+
+	TestEqual("Every enemy count was run", Summaries.Num(), EnemyCounts.Num());
+
+	// Write the results where CI can pick them up
+	const FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("CombatBenchmark"));
+	const FString SummaryPath = FPaths::Combine(OutputDir, TEXT("CombatBenchmarkSummary.csv"));
+	TestTrue("Frame CSV was written", FFileHelper::SaveStringToFile(FramesCsv, *FPaths::Combine(OutputDir, TEXT("CombatBenchmarkFrames.csv"))));
+	TestTrue("Summary CSV was written", FFileHelper::SaveStringToFile(SummaryCsv, *SummaryPath));
+	UE_LOG(LogTemp, Display, TEXT("[CombatBenchmark] Results written to %s"), *OutputDir);
+
+	// Compare against a baseline if one was given
+	FString BaselinePath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("CombatBenchmarkBaseline="), BaselinePath))
+	{
+		float Tolerance = 1.2f;
+		FParse::Value(FCommandLine::Get(), TEXT("CombatBenchmarkTolerance="), Tolerance);
+
+		const TMap<int32, double> Baseline = LoadBaseline(BaselinePath);
+		if (Baseline.IsEmpty())
+		{
+			AddWarning(FString::Printf(TEXT("Could not read a baseline from %s"), *BaselinePath));
+		}
+
+		for (const FRunSummary& Summary : Summaries)
+		{
+			if (const double* BaselineMs = Baseline.Find(Summary.NumEnemies))
+			{
+				if (Summary.AvgGameThreadMs > *BaselineMs * Tolerance)
+				{
+					AddError(FString::Printf(TEXT("%d enemies: average frame %.2f ms regressed past baseline %.2f ms x %.2f"),
+						Summary.NumEnemies, Summary.AvgGameThreadMs, *BaselineMs, Tolerance));
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,121 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "AntigravityTest/Component/InputBufferComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputBufferTest, "AntigravityTest.InputBuffer", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FInputBufferTest::RunTest(const FString& Parameters)
+{
+	// Create a temporary world
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	if (!World)
+	{
+		AddError("Failed to create World");
+		return false;
+	}
+
+	AActor* Owner = World->SpawnActor<AActor>();
+	if (!Owner)
+	{
+		AddError("Failed to spawn owner");
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	UInputBufferComponent* Buffer = NewObject<UInputBufferComponent>(Owner);
+	Buffer->RegisterComponent();
+
+	const EBufferedInputType AttackMask = EBufferedInputType::ComboAttack | EBufferedInputType::ChargedAttackPress;
+
+	// Inputs are consumed oldest first, and other kinds are left alone
+	Buffer->BufferInput(EBufferedInputType::Jump);
+	Buffer->BufferInput(EBufferedInputType::ComboAttack);
+	Buffer->BufferInput(EBufferedInputType::ChargedAttackPress);
+
+	EBufferedInputType Consumed = EBufferedInputType::None;
+	TestTrue("First attack input is consumed", Buffer->ConsumeInput(AttackMask, 1, &Consumed));
+	TestTrue("Oldest attack input comes first", Consumed == EBufferedInputType::ComboAttack);
+	TestTrue("Second attack input is consumed", Buffer->ConsumeInput(AttackMask, 1, &Consumed));
+	TestTrue("Newer attack input comes second", Consumed == EBufferedInputType::ChargedAttackPress);
+	TestFalse("No attack input is left", Buffer->ConsumeInput(AttackMask, 1));
+	TestTrue("Jump input is still pending", Buffer->HasInput(EBufferedInputType::Jump, 1));
+
+	// Inputs age by engine frames, not world time
+	Buffer->BufferInput(EBufferedInputType::Dash);
+	GFrameCounter += 3;
+	TestTrue("Input is pending within its frame window", Buffer->HasInput(EBufferedInputType::Dash, 3));
+	TestFalse("Input is stale past its frame window", Buffer->HasInput(EBufferedInputType::Dash, 2));
+	TestFalse("Stale input is not consumed", Buffer->ConsumeInput(EBufferedInputType::Dash, 2));
+	TestEqual("Seconds convert to frames at the reference rate", UInputBufferComponent::SecondsToFrames(0.5f), 30);
+
+	// Stale inputs are dropped instead of consumed
+	TestFalse("Negative max age rejects every input", Buffer->ConsumeInput(EBufferedInputType::Jump, -1));
+	TestEqual("Stale jump was dropped", Buffer->GetNumInputs(), 0);
+
+	// A full buffer overwrites its oldest input
+	Buffer->BufferInput(EBufferedInputType::Dash);
+	for (int32 Index = 0; Index < UInputBufferComponent::Capacity; ++Index)
+	{
+		Buffer->BufferInput(EBufferedInputType::Jump);
+	}
+	TestEqual("Buffer is capped at capacity", Buffer->GetNumInputs(), UInputBufferComponent::Capacity);
+	TestFalse("Oldest input was overwritten", Buffer->HasInput(EBufferedInputType::Dash, 1));
+
+	// Saved states can be restored after the buffer changed
+	FInputBufferState State;
+	Buffer->SaveState(State);
+	Buffer->ClearInputs(EBufferedInputType::Jump);
+	TestEqual("Clear drops matching inputs", Buffer->GetNumInputs(), 0);
+	Buffer->RestoreState(State);
+	TestEqual("Restore brings the inputs back", Buffer->GetNumInputs(), UInputBufferComponent::Capacity);
+
+	// Record inputs on different frames
+	Buffer->ClearInputs(EBufferedInputType::Jump);
+	Buffer->StartRecording();
+	Buffer->RecordInput(EBufferedInputType::ComboAttack);
+	GFrameCounter += 3;
+	Buffer->BufferInput(EBufferedInputType::ChargedAttackPress);
+	const TArray<FBufferedInput> Log = Buffer->StopRecording();
+
+	TestEqual("Both inputs were recorded", Log.Num(), 2);
+	if (Log.Num() == 2)
+	{
+		TestEqual("First input is on the first frame", Log[0].Frame, (uint64)0);
+		TestEqual("Second input is three frames later", Log[1].Frame, (uint64)3);
+	}
+
+	// Replay them with two frames of latency
+	TArray<TPair<EBufferedInputType, uint64>> Replayed;
+	Buffer->OnReplayInput.AddLambda([&Replayed](EBufferedInputType Type)
+	{
+		Replayed.Emplace(Type, GFrameCounter);
+	});
+
+	const uint64 ReplayStartFrame = GFrameCounter;
+	Buffer->StartReplay(Log, 2);
+	TestEqual("Replay starts from an empty buffer", Buffer->GetNumInputs(), 0);
+
+	for (int32 Frame = 0; Frame < 8 && Buffer->IsReplaying(); ++Frame)
+	{
+		Buffer->TickComponent(1.0f / 60.0f, LEVELTICK_All, nullptr);
+		++GFrameCounter;
+	}
+
+	TestFalse("Replay finished", Buffer->IsReplaying());
+	TestEqual("Both inputs were replayed", Replayed.Num(), 2);
+	if (Replayed.Num() == 2)
+	{
+		TestTrue("Replayed inputs keep their order", Replayed[0].Key == EBufferedInputType::ComboAttack && Replayed[1].Key == EBufferedInputType::ChargedAttackPress);
+		TestEqual("First input is delayed by the latency", Replayed[0].Value - ReplayStartFrame, (uint64)2);
+		TestEqual("Second input keeps its spacing", Replayed[1].Value - ReplayStartFrame, (uint64)5);
+	}
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
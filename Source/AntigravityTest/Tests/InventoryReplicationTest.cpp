@@ -0,0 +1,168 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "AntigravityTest/Component/InventoryComponent.h"
+#include "AntigravityTest/Items/ItemDefinition.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryReplicationTest, "AntigravityTest.Inventory.Replication", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FInventoryReplicationTest::RunTest(const FString& Parameters)
+{
+	// Create a temporary world
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	if (!World)
+	{
+		AddError("Failed to create World");
+		return false;
+	}
+
+	// Spawn a server-side owner and a client-side owner
+	AActor* ServerActor = World->SpawnActor<AActor>();
+	AActor* ClientActor = World->SpawnActor<AActor>();
+	if (!ServerActor || !ClientActor)
+	{
+		AddError("Failed to spawn owners");
+		World->DestroyWorld(false);
+		return false;
+	}
+	ClientActor->SetRole(ROLE_SimulatedProxy);
+
+	UInventoryComponent* ServerInventory = NewObject<UInventoryComponent>(ServerActor);
+	ServerInventory->RegisterComponent();
+	UInventoryComponent* ClientInventory = NewObject<UInventoryComponent>(ClientActor);
+	ClientInventory->RegisterComponent();
+
+	UItemDefinition* ItemA = NewObject<UItemDefinition>();
+	UItemDefinition* ItemB = NewObject<UItemDefinition>();
+	UItemDefinition* ItemC = NewObject<UItemDefinition>();
+
+	// Populate the server
+	TArray<FInventoryItem> Batch;
+	Batch.AddDefaulted(3);
+	Batch[0].ItemDef = ItemA;
+	Batch[0].Quantity = 1;
+	Batch[1].ItemDef = ItemB;
+	Batch[1].Quantity = 2;
+	Batch[2].ItemDef = ItemC;
+	Batch[2].Quantity = 3;
+	ServerInventory->AddItems(Batch);
+
+	const TArray<FInventoryItem>& ServerItems = ServerInventory->GetItems();
+	TestEqual("Server holds three entries", ServerItems.Num(), 3);
+
+	// Only the entry that changed should be marked dirty
+	TArray<int32> KeysBefore;
+	for (const FInventoryItem& Item : ServerItems)
+	{
+		KeysBefore.Add(Item.ReplicationKey);
+	}
+
+	ServerInventory->AddItem(ItemB, 1);
+	TestEqual("Unchanged entry A keeps its replication key", ServerItems[0].ReplicationKey, KeysBefore[0]);
+	TestNotEqual("Changed entry B gets a new replication key", ServerItems[1].ReplicationKey, KeysBefore[1]);
+	TestEqual("Unchanged entry C keeps its replication key", ServerItems[2].ReplicationKey, KeysBefore[2]);
+
+	// Clients must not diverge from the replicated list
+	AddExpectedMessage(TEXT("can only be modified on the server"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 1);
+	ClientInventory->AddItem(ItemA, 1);
+	TestEqual("Client-side AddItem is rejected", ClientInventory->GetItems().Num(), 0);
+
+	// We reach the protected replicated list using reflection, and drive its callbacks in the order the fast array does
+	FStructProperty* InventoryProp = FindFProperty<FStructProperty>(UInventoryComponent::StaticClass(), TEXT("Inventory"));
+	if (!InventoryProp)
+	{
+		AddError("UInventoryComponent has no Inventory property");
+		World->DestroyWorld(false);
+		return false;
+	}
+	FInventoryList* ClientList = InventoryProp->ContainerPtrToValuePtr<FInventoryList>(ClientInventory);
+
+	// Mirror the client's list purely from change sets, the same way the inventory widget does
+	TArray<TPair<const UItemDefinition*, int32>> Mirror;
+	int32 NumAdded = 0;
+	int32 NumChanged = 0;
+	int32 NumRemoved = 0;
+
+	ClientInventory->OnReplicatedItemAdded.AddLambda([&NumAdded](const FInventoryItem&, int32) { ++NumAdded; });
+	ClientInventory->OnReplicatedItemChanged.AddLambda([&NumChanged](const FInventoryItem&, int32) { ++NumChanged; });
+	ClientInventory->OnReplicatedItemRemoved.AddLambda([&NumRemoved](const FInventoryItem&, int32) { ++NumRemoved; });
+	ClientInventory->OnInventoryChanged.AddLambda([&Mirror](const FInventoryChangeSet& ChangeSet)
+	{
+		for (const FInventoryChange& Change : ChangeSet.Changes)
+		{
+			switch (Change.Type)
+			{
+			case EInventoryChangeType::Added:
+				Mirror.Emplace(Change.ItemDef, Change.Quantity);
+				break;
+			case EInventoryChangeType::QuantityChanged:
+				Mirror[Change.Index].Value = Change.Quantity;
+				break;
+			case EInventoryChangeType::Removed:
+				Mirror.RemoveAtSwap(Change.Index);
+				break;
+			}
+		}
+	});
+
+	auto MirrorMatchesClient = [&Mirror, ClientInventory]()
+	{
+		const TArray<FInventoryItem>& ClientItems = ClientInventory->GetItems();
+		if (Mirror.Num() != ClientItems.Num())
+		{
+			return false;
+		}
+
+		for (int32 Index = 0; Index < Mirror.Num(); ++Index)
+		{
+			if (Mirror[Index].Key != ClientItems[Index].ItemDef || Mirror[Index].Value != ClientItems[Index].Quantity)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// Initial replication: every entry arrives as an add
+	ClientList->Items = ServerItems;
+	TArray<int32> AddedIndices = { 0, 1, 2 };
+	ClientList->PostReplicatedAdd(AddedIndices, 3);
+	ClientList->PostReplicatedReceive(FFastArraySerializer::FPostReplicatedReceiveParameters());
+
+	TestEqual("Client got one add callback per entry", NumAdded, 3);
+	TestTrue("Mirror matches client after initial replication", MirrorMatchesClient());
+	TestEqual("Client index resolves B", ClientInventory->GetItemQuantity(ItemB), 3);
+
+	// Server removes A and changes C in one batch; the fast array reports removes, then changes, then swap-removes
+	TArray<FInventoryItem> RemoveBatch;
+	RemoveBatch.AddDefaulted(2);
+	RemoveBatch[0].ItemDef = ItemA;
+	RemoveBatch[0].Quantity = 1;
+	RemoveBatch[1].ItemDef = ItemC;
+	RemoveBatch[1].Quantity = 1;
+	TestEqual("Server removed both entries", ServerInventory->RemoveItems(RemoveBatch), 2);
+
+	TArray<int32> RemovedIndices = { 0 };
+	ClientList->PreReplicatedRemove(RemovedIndices, 2);
+	ClientList->Items[2].Quantity = 2;
+	TArray<int32> ChangedIndices = { 2 };
+	ClientList->PostReplicatedChange(ChangedIndices, 2);
+	ClientList->Items.RemoveAtSwap(0);
+	ClientList->PostReplicatedReceive(FFastArraySerializer::FPostReplicatedReceiveParameters());
+
+	TestEqual("Client got one remove callback", NumRemoved, 1);
+	TestEqual("Client got one change callback", NumChanged, 1);
+	TestTrue("Mirror matches client after removal", MirrorMatchesClient());
+	TestEqual("Client no longer holds A", ClientInventory->GetItemQuantity(ItemA), 0);
+	TestEqual("Client index follows the swapped entry C", ClientInventory->GetItemQuantity(ItemC), 2);
+
+	// Clean up
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
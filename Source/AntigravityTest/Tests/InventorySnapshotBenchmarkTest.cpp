@@ -0,0 +1,77 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "AntigravityTest/Items/InventorySnapshot.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySnapshotBenchmarkTest, "AntigravityTest.Inventory.SnapshotBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FInventorySnapshotBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 NumEntries = 100000;
+
+	// Build a large inventory spread over a few asset types, quantities covering all varint widths
+	const FPrimaryAssetType ItemTypes[] = { FName(TEXT("ItemDefinition")), FName(TEXT("Consumable")), FName(TEXT("Material")) };
+
+	FInventorySnapshot Snapshot;
+	Snapshot.Entries.Reserve(NumEntries);
+	for (int32 Index = 0; Index < NumEntries; ++Index)
+	{
+		FInventorySnapshotEntry& Entry = Snapshot.Entries.AddDefaulted_GetRef();
+		Entry.ItemId = FPrimaryAssetId(ItemTypes[Index % UE_ARRAY_COUNT(ItemTypes)], FName(*FString::Printf(TEXT("Item_%d"), Index)));
+		Entry.Quantity = (Index * 7919) % 100000;
+	}
+
+	// Encode
+	TArray<uint8> Bytes;
+	double StartTime = FPlatformTime::Seconds();
+	Snapshot.Encode(Bytes);
+	const double EncodeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Write to disk
+	const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("InventorySnapshotBenchmark.inv"));
+	StartTime = FPlatformTime::Seconds();
+	const bool bSaved = FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+	const double SaveMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	TestTrue("Snapshot was written", bSaved);
+
+	// Read back and decode
+	TArray<uint8> LoadedBytes;
+	StartTime = FPlatformTime::Seconds();
+	const bool bLoaded = FFileHelper::LoadFileToArray(LoadedBytes, *FilePath);
+	FInventorySnapshot Decoded;
+	const bool bDecoded = bLoaded && Decoded.Decode(LoadedBytes);
+	const double LoadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	TestTrue("Snapshot was decoded", bDecoded);
+
+	IFileManager::Get().Delete(*FilePath);
+
+	// Round trip must be exact
+	TestEqual("Entry count survives the round trip", Decoded.Entries.Num(), NumEntries);
+	bool bEntriesMatch = Decoded.Entries.Num() == NumEntries;
+	for (int32 Index = 0; bEntriesMatch && Index < NumEntries; ++Index)
+	{
+		bEntriesMatch = Decoded.Entries[Index].ItemId == Snapshot.Entries[Index].ItemId
+			&& Decoded.Entries[Index].Quantity == Snapshot.Entries[Index].Quantity;
+	}
+	TestTrue("Entries survive the round trip", bEntriesMatch);
+
+	// Corrupted or truncated data must be rejected rather than half applied
+	TArray<uint8> Truncated = Bytes;
+	Truncated.SetNum(Bytes.Num() / 2);
+	FInventorySnapshot Rejected;
+	TestFalse("Truncated snapshot is rejected", Rejected.Decode(Truncated));
+	TestEqual("Rejected snapshot has no entries", Rejected.Entries.Num(), 0);
+
+	const FString Summary = FString::Printf(TEXT("%d entries: %d bytes (%.2f bytes/entry), encode %.2f ms, write %.2f ms, read+decode %.2f ms"),
+		NumEntries, Bytes.Num(), double(Bytes.Num()) / NumEntries, EncodeMs, SaveMs, LoadMs);
+	AddInfo(Summary);
+	UE_LOG(LogTemp, Display, TEXT("[InventorySnapshotBenchmark] %s"), *Summary);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,113 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "AntigravityTest/Component/InventoryComponent.h"
+#include "AntigravityTest/Items/InventorySnapshot.h"
+#include "AntigravityTest/Items/ItemDefinition.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySnapshotTest, "AntigravityTest.Inventory.Snapshot", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FInventorySnapshotTest::RunTest(const FString& Parameters)
+{
+	if (!UAssetManager::IsInitialized())
+	{
+		AddError("Asset manager is not initialized");
+		return false;
+	}
+
+	// The test item must be reachable through its primary asset id, the same way snapshots resolve items
+	UAssetManager& AssetManager = UAssetManager::Get();
+	const FPrimaryAssetId ItemId(FName(TEXT("ItemDefinition")), FName(TEXT("DA_TestItem")));
+	UItemDefinition* Item = Cast<UItemDefinition>(AssetManager.GetPrimaryAssetPath(ItemId).TryLoad());
+	if (!Item)
+	{
+		AddError("DA_TestItem is not registered as an ItemDefinition primary asset");
+		return false;
+	}
+
+	// Create a temporary world
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	if (!World)
+	{
+		AddError("Failed to create World");
+		return false;
+	}
+
+	AActor* Owner = World->SpawnActor<AActor>();
+	if (!Owner)
+	{
+		AddError("Failed to spawn owner");
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	UInventoryComponent* Inventory = NewObject<UInventoryComponent>(Owner);
+	Inventory->RegisterComponent();
+	Inventory->AddItem(Item, 5);
+
+	// Saving and loading finish on the game thread, so pump it until the callback fires
+	auto WaitFor = [](const bool& bDone)
+	{
+		const double Deadline = FPlatformTime::Seconds() + 10.0;
+		while (!bDone && FPlatformTime::Seconds() < Deadline)
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FPlatformProcess::Sleep(0.001f);
+		}
+		return bDone;
+	};
+
+	bool bDone = false;
+	bool bSuccess = false;
+	FOnInventorySnapshotComplete OnComplete = FOnInventorySnapshotComplete::CreateLambda([&bDone, &bSuccess](bool bInSuccess)
+	{
+		bDone = true;
+		bSuccess = bInSuccess;
+	});
+
+	// Save, change the inventory, then load the save back
+	const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("InventorySnapshotTest.inv"));
+	Inventory->SaveSnapshotAsync(FilePath, OnComplete);
+	TestTrue("Save completed", WaitFor(bDone));
+	TestTrue("Save succeeded", bSuccess);
+
+	Inventory->AddItem(Item, 3);
+
+	bDone = false;
+	bSuccess = false;
+	Inventory->LoadSnapshotAsync(FilePath, OnComplete);
+	TestTrue("Load completed", WaitFor(bDone));
+	TestTrue("Load succeeded", bSuccess);
+	TestEqual("Loaded inventory matches the save", Inventory->GetItemQuantity(Item), 5);
+	TestEqual("Loaded inventory holds one entry", Inventory->GetItems().Num(), 1);
+
+	IFileManager::Get().Delete(*FilePath);
+
+	// A snapshot with an item that can't be resolved must fail and leave the inventory alone
+	FInventorySnapshot Unresolvable;
+	Unresolvable.Entries.Add({ ItemId, 1 });
+	Unresolvable.Entries.Add({ FPrimaryAssetId(FName(TEXT("ItemDefinition")), FName(TEXT("DoesNotExist"))), 1 });
+
+	AddExpectedMessage(TEXT("could not be resolved"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 1);
+
+	bDone = false;
+	bSuccess = true;
+	Inventory->ApplySnapshot(Unresolvable, OnComplete);
+	TestTrue("Unresolvable apply completed", WaitFor(bDone));
+	TestFalse("Unresolvable apply reports failure", bSuccess);
+	TestEqual("Unresolvable apply leaves the inventory unchanged", Inventory->GetItemQuantity(Item), 5);
+
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,278 @@
+#include "InventoryIconCache.h"
+#include "Items/ItemDefinition.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Canvas.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/StreamableManager.h"
+#include "Kismet/KismetRenderingLibrary.h"
+#include "HAL/IConsoleManager.h"
+#include "CoreGlobals.h"
+#include "Misc/App.h"
+
+static TAutoConsoleVariable<int32> CVarInventoryIconAtlasSize(
+	TEXT("Inventory.IconAtlas.Size"),
+	1024,
+	TEXT("Edge length in pixels of the runtime inventory icon atlas."));
+
+static TAutoConsoleVariable<int32> CVarInventoryIconAtlasCellSize(
+	TEXT("Inventory.IconAtlas.CellSize"),
+	64,
+	TEXT("Edge length in pixels of one icon in the runtime inventory icon atlas. Icons are scaled to fit."));
+
+static TAutoConsoleVariable<int32> CVarInventoryIconCacheEvictFrames(
+	TEXT("Inventory.IconCache.EvictFrames"),
+	120,
+	TEXT("Inventory icons that have not been drawn for this many frames are evicted, freeing their atlas cell or source texture."));
+
+FInventoryIconCache::FInventoryIconCache(UObject* InWorldContext, bool bUseAtlas)
+	: WorldContext(InWorldContext)
+	, bAtlasEnabled(bUseAtlas && FApp::CanEverRender())
+{
+}
+
+FInventoryIconCache::~FInventoryIconCache()
+{
+	for (const TPair<int32, TSharedPtr<FStreamableHandle>>& Pair : LoadHandles)
+	{
+		if (Pair.Value.IsValid())
+		{
+			Pair.Value->CancelHandle();
+		}
+	}
+}
+
+void FInventoryIconCache::RequestIcon(const UItemDefinition* ItemDef)
+{
+	if (!ItemDef || ItemDef->Icon.IsNull())
+	{
+		return;
+	}
+
+	const FSoftObjectPath& IconPath = ItemDef->Icon.ToSoftObjectPath();
+	if (Icons.Contains(IconPath) || InFlightPaths.Contains(IconPath))
+	{
+		return;
+	}
+
+	QueuedPaths.Add(IconPath);
+}
+
+void FInventoryIconCache::FlushRequests()
+{
+	EvictUnusedIcons();
+
+	if (QueuedPaths.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> Paths = QueuedPaths.Array();
+	QueuedPaths.Reset();
+	InFlightPaths.Append(Paths);
+
+	// one request for the whole batch, completing immediately if everything is already resident
+	const int32 BatchId = NextBatchId++;
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		Paths,
+		FStreamableDelegate::CreateSP(this, &FInventoryIconCache::OnIconsLoaded, BatchId, Paths),
+		FStreamableManager::AsyncLoadHighPriority);
+
+	// the callback may already have run if every icon was resident, in which case there is nothing to hold on to
+	if (Handle.IsValid() && InFlightPaths.Contains(Paths[0]))
+	{
+		LoadHandles.Add(BatchId, Handle);
+	}
+}
+
+const FSlateBrush* FInventoryIconCache::GetIconBrush(const UItemDefinition* ItemDef)
+{
+	if (!ItemDef || ItemDef->Icon.IsNull())
+	{
+		return nullptr;
+	}
+
+	FIconEntry* Entry = Icons.Find(ItemDef->Icon.ToSoftObjectPath());
+	if (!Entry)
+	{
+		// evicted while its tile stayed in view, stream it back in
+		RequestIcon(ItemDef);
+		return nullptr;
+	}
+
+	Entry->LastUsedFrame = GFrameCounter;
+	return &Entry->Brush;
+}
+
+void FInventoryIconCache::EvictUnusedIcons()
+{
+	const uint64 EvictFrames = (uint64)FMath::Max(1, CVarInventoryIconCacheEvictFrames.GetValueOnGameThread());
+	if (GFrameCounter <= EvictFrames)
+	{
+		return;
+	}
+
+	const uint64 OldestKeptFrame = GFrameCounter - EvictFrames;
+	for (auto It = Icons.CreateIterator(); It; ++It)
+	{
+		if (It.Value().LastUsedFrame < OldestKeptFrame)
+		{
+			if (It.Value().AtlasCell != INDEX_NONE)
+			{
+				FreeAtlasCells.Add(It.Value().AtlasCell);
+			}
+
+			It.RemoveCurrent();
+		}
+	}
+}
+
+int32 FInventoryIconCache::AllocateAtlasCell(int32 NumCells)
+{
+	if (!FreeAtlasCells.IsEmpty())
+	{
+		return FreeAtlasCells.Pop(EAllowShrinking::No);
+	}
+
+	if (NextAtlasCell < NumCells)
+	{
+		return NextAtlasCell++;
+	}
+
+	// the atlas is full, take the cell of the least recently drawn icon that is off screen. Loads land before this
+	// frame's paint, so anything drawn last frame is still on screen and keeps its cell
+	FSoftObjectPath OldestPath;
+	uint64 OldestFrame = GFrameCounter > 0 ? GFrameCounter - 1 : 0;
+
+	for (const TPair<FSoftObjectPath, FIconEntry>& Pair : Icons)
+	{
+		if (Pair.Value.AtlasCell != INDEX_NONE && Pair.Value.LastUsedFrame < OldestFrame)
+		{
+			OldestPath = Pair.Key;
+			OldestFrame = Pair.Value.LastUsedFrame;
+		}
+	}
+
+	if (OldestPath.IsNull())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Cell = Icons[OldestPath].AtlasCell;
+	Icons.Remove(OldestPath);
+	return Cell;
+}
+
+void FInventoryIconCache::OnIconsLoaded(int32 BatchId, TArray<FSoftObjectPath> Paths)
+{
+	UCanvas* Canvas = nullptr;
+	FVector2D CanvasSize;
+	FDrawToRenderTargetContext DrawContext;
+	bool bDrawing = false;
+	bool bCanvasFailed = false;
+
+	const bool bAtlasReady = EnsureAtlas();
+	const int32 AtlasSize = bAtlasReady ? Atlas->SizeX : 0;
+	const int32 CellSize = FMath::Max(1, CVarInventoryIconAtlasCellSize.GetValueOnGameThread());
+	const int32 CellsPerRow = AtlasSize / CellSize;
+
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		InFlightPaths.Remove(Path);
+
+		UTexture2D* Texture = Cast<UTexture2D>(Path.ResolveObject());
+		if (!Texture)
+		{
+			continue;
+		}
+
+		// take a cell first, recycling one may evict another icon
+		int32 Cell = bAtlasReady && !bCanvasFailed ? AllocateAtlasCell(CellsPerRow * CellsPerRow) : INDEX_NONE;
+
+		// all icons of the batch are drawn into the atlas in a single canvas pass
+		if (Cell != INDEX_NONE && !bDrawing)
+		{
+			UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(WorldContext.Get(), Atlas, Canvas, CanvasSize, DrawContext);
+			bDrawing = Canvas != nullptr;
+			if (!bDrawing)
+			{
+				bCanvasFailed = true;
+				FreeAtlasCells.Add(Cell);
+				Cell = INDEX_NONE;
+			}
+		}
+
+		FIconEntry& Entry = Icons.Add(Path);
+		Entry.LastUsedFrame = GFrameCounter;
+
+		if (Cell == INDEX_NONE)
+		{
+			// atlas disabled, unavailable or entirely on screen, draw this icon from its own texture until it's evicted
+			Entry.Brush.SetResourceObject(Texture);
+			Entry.Brush.ImageSize = FVector2D(Texture->GetSizeX(), Texture->GetSizeY());
+			Entry.DirectTexture = Texture;
+			continue;
+		}
+
+		// opaque blending overwrites the cell, alpha included, so a recycled cell keeps nothing of its previous icon
+		const FVector2D CellPosition((Cell % CellsPerRow) * CellSize, (Cell / CellsPerRow) * CellSize);
+		Canvas->K2_DrawTexture(Texture, CellPosition, FVector2D(CellSize, CellSize), FVector2D::ZeroVector, FVector2D::UnitVector, FLinearColor::White, BLEND_Opaque);
+
+		const FVector2f UVMin = FVector2f(CellPosition) / AtlasSize;
+		const FVector2f UVMax = FVector2f(CellPosition + FVector2D(CellSize, CellSize)) / AtlasSize;
+		Entry.AtlasCell = Cell;
+		Entry.Brush.SetResourceObject(Atlas);
+		Entry.Brush.SetUVRegion(FBox2f(UVMin, UVMax));
+		Entry.Brush.ImageSize = FVector2D(CellSize, CellSize);
+	}
+
+	if (bDrawing)
+	{
+		UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(WorldContext.Get(), DrawContext);
+	}
+
+	// atlased icons live on in the atlas, so the source textures no longer need to stay resident
+	LoadHandles.Remove(BatchId);
+}
+
+bool FInventoryIconCache::EnsureAtlas()
+{
+	if (!bAtlasEnabled)
+	{
+		return false;
+	}
+
+	if (!Atlas)
+	{
+		UObject* Context = WorldContext.Get();
+		if (!Context)
+		{
+			return false;
+		}
+
+		const int32 AtlasSize = FMath::Max(1, CVarInventoryIconAtlasSize.GetValueOnGameThread());
+		Atlas = UKismetRenderingLibrary::CreateRenderTarget2D(Context, AtlasSize, AtlasSize, RTF_RGBA8, FLinearColor::Transparent);
+		if (!Atlas)
+		{
+			bAtlasEnabled = false;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FInventoryIconCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(Atlas);
+
+	for (TPair<FSoftObjectPath, FIconEntry>& Pair : Icons)
+	{
+		Collector.AddReferencedObject(Pair.Value.DirectTexture);
+	}
+}
+
+FString FInventoryIconCache::GetReferencerName() const
+{
+	return TEXT("FInventoryIconCache");
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "UObject/SoftObjectPath.h"
+#include "Styling/SlateBrush.h"
+
+class UItemDefinition;
+class UTexture2D;
+class UTextureRenderTarget2D;
+struct FStreamableHandle;
+
+/**
+ * Streams item icons for the inventory UI on demand and optionally packs them into a runtime atlas.
+ * Icons are only requested for slots that become visible, and all requests made in a frame are
+ * loaded with a single async request. With the atlas enabled each icon is copied into a fixed-size
+ * cell of one render target and the source texture is released, so every tile draws from the same
+ * texture and resident icon memory does not depend on the source icon resolution.
+ * Icons that have not been drawn for a while are evicted, and when the atlas is full the least recently
+ * drawn off-screen icon gives up its cell, so resident icons track what is on screen rather than
+ * every icon ever shown.
+ */
+class ANTIGRAVITYTEST_API FInventoryIconCache : public FGCObject, public TSharedFromThis<FInventoryIconCache>
+{
+public:
+	// WorldContext is used to draw into the atlas, bUseAtlas is ignored when rendering is unavailable
+	FInventoryIconCache(UObject* InWorldContext, bool bUseAtlas);
+	virtual ~FInventoryIconCache();
+
+	// Queues the icon of an item that became visible
+	void RequestIcon(const UItemDefinition* ItemDef);
+
+	// Starts one async load for every icon queued since the last flush
+	void FlushRequests();
+
+	// Returns the brush for an item's icon and marks it as drawn, or nullptr while the icon is streaming
+	const FSlateBrush* GetIconBrush(const UItemDefinition* ItemDef);
+
+	// Number of icons currently packed into the atlas
+	int32 GetNumAtlasedIcons() const { return NextAtlasCell - FreeAtlasCells.Num(); }
+
+	// Number of resident icons, atlased or not
+	int32 GetNumResidentIcons() const { return Icons.Num(); }
+
+	//~Begin FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+	//~End FGCObject interface
+
+private:
+	// Called when an async batch finishes loading
+	void OnIconsLoaded(int32 BatchId, TArray<FSoftObjectPath> Paths);
+
+	// Creates the atlas render target on first use. Returns false if no atlas can be used
+	bool EnsureAtlas();
+
+	// A resident icon
+	struct FIconEntry
+	{
+		FSlateBrush Brush;
+
+		// Atlas cell holding the icon, or INDEX_NONE if it's drawn from DirectTexture
+		int32 AtlasCell = INDEX_NONE;
+
+		// Source texture kept resident for an icon that did not go into the atlas
+		TObjectPtr<UTexture2D> DirectTexture = nullptr;
+
+		// Frame the icon was last drawn in
+		uint64 LastUsedFrame = 0;
+	};
+
+	// Drops icons that have not been drawn recently, returning their atlas cells and source textures
+	void EvictUnusedIcons();
+
+	// Returns a free atlas cell, recycling the least recently drawn off-screen icon when the atlas is full. INDEX_NONE if every cell is in use
+	int32 AllocateAtlasCell(int32 NumCells);
+
+	// Resident icons keyed by icon path, several items may share one icon
+	TMap<FSoftObjectPath, FIconEntry> Icons;
+
+	// Icons queued since the last flush
+	TSet<FSoftObjectPath> QueuedPaths;
+
+	// Icons currently being loaded
+	TSet<FSoftObjectPath> InFlightPaths;
+
+	// Async requests in flight, keyed by batch id
+	TMap<int32, TSharedPtr<FStreamableHandle>> LoadHandles;
+	int32 NextBatchId = 0;
+
+	// Runtime atlas, the next never used cell in it and the cells given back by evicted icons
+	TObjectPtr<UTextureRenderTarget2D> Atlas = nullptr;
+	int32 NextAtlasCell = 0;
+	TArray<int32> FreeAtlasCells;
+
+	TWeakObjectPtr<UObject> WorldContext;
+	bool bAtlasEnabled = false;
+};
@@ -1,18 +1,28 @@
 #include "SInventoryWidget.h"
 #include "SlateOptMacros.h"
-#include "Widgets/Layout/SGridPanel.h"
+#include "Widgets/Views/STileView.h"
+#include "Widgets/Views/STableRow.h"
 #include "Widgets/Layout/SBorder.h"
 #include "Widgets/Images/SImage.h"
 #include "Widgets/Text/STextBlock.h"
+#include "Widgets/Layout/SBox.h"
+#include "InventoryIconCache.h"
 #include "Component/InventoryComponent.h"
 #include "Items/ItemDefinition.h"
 
 
+static const int32 InventoryGridColumns = 3;
+static const float InventoryTileHeight = 130.0f;
+static const float InventoryIconSize = 40.0f;
 
-static TSharedRef<SWidget> CreateItemSlotWidget(const FInventoryItem* Item)
+static FText MakeQuantityText(int32 Quantity)
 {
-	FString ItemName = Item ? Item->ItemDef->ItemName.ToString() : "Empty";
-	FString QuantityText = Item ? FString::Printf(TEXT("x%d"), Item->Quantity) : "";
+	return FText::FromString(FString::Printf(TEXT("x%d"), Quantity));
+}
+
+static TSharedRef<SWidget> CreateItemSlotWidget(const UItemDefinition* ItemDef, const TAttribute<FText>& QuantityText, const TAttribute<const FSlateBrush*>& IconBrush)
+{
+	const FText ItemName = ItemDef ? ItemDef->ItemName : FText::FromString("Empty");
 
 	return SNew(SBorder)
 		.BorderImage(FCoreStyle::Get().GetBrush("WhiteBrush"))
@@ -25,9 +35,21 @@ static TSharedRef<SWidget> CreateItemSlotWidget(const FInventoryItem* Item)
 			+ SVerticalBox::Slot()
 			.AutoHeight()
 			.HAlign(HAlign_Center)
+			[
+				SNew(SBox)
+				.WidthOverride(InventoryIconSize)
+				.HeightOverride(InventoryIconSize)
+				[
+					SNew(SImage)
+					.Image(IconBrush)
+				]
+			]
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.HAlign(HAlign_Center)
 			[
 				SNew(STextBlock)
-				.Text(FText::FromString(ItemName))
+				.Text(ItemName)
 				.ColorAndOpacity(FLinearColor::White)
 			]
 			+ SVerticalBox::Slot()
@@ -35,7 +57,7 @@ static TSharedRef<SWidget> CreateItemSlotWidget(const FInventoryItem* Item)
 			.HAlign(HAlign_Center)
 			[
 				SNew(STextBlock)
-				.Text(FText::FromString(QuantityText))
+				.Text(QuantityText)
 				.ColorAndOpacity(FLinearColor::Gray)
 			]
 		];
@@ -45,11 +67,12 @@ BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 void SInventoryWidget::Construct(const FArguments& InArgs)
 {
 	InventoryComponent = InArgs._InventoryComponent;
+	IconCache = MakeShared<FInventoryIconCache>(InventoryComponent.Get(), InArgs._UseIconAtlas);
 	const FMargin SlotPadding = FMargin(10.0f);
 
 	if (InventoryComponent.IsValid())
 	{
-		InventoryComponent->OnInventoryUpdated.AddRaw(this, &SInventoryWidget::RefreshList);
+		InventoryChangedHandle = InventoryComponent->OnInventoryChanged.AddRaw(this, &SInventoryWidget::ApplyChanges);
 	}
 
 	ChildSlot
@@ -126,11 +149,14 @@ void SInventoryWidget::Construct(const FArguments& InArgs)
 						.Padding(0.0f)
 						[
 
-							// Grid Panel (Dynamic)
-							SAssignNew(ItemGrid, SGridPanel)
-							.FillColumn(0, 1.0f)
-							.FillColumn(1, 1.0f)
-							.FillColumn(2, 1.0f)
+							// Tile View (Virtualized, only visible rows get widgets)
+							SAssignNew(ItemTileView, STileView<FInventorySlotEntryPtr>)
+							.ListItemsSource(&SlotEntries)
+							.OnGenerateTile(this, &SInventoryWidget::GenerateItemTile)
+							.SelectionMode(ESelectionMode::None)
+							.ItemWidth(this, &SInventoryWidget::GetTileWidth)
+							.ItemHeight(InventoryTileHeight)
+							.ItemAlignment(EListItemAlignment::EvenlyWide)
 						]
 					]
 				]
@@ -143,38 +169,155 @@ void SInventoryWidget::Construct(const FArguments& InArgs)
 
 void SInventoryWidget::RefreshList()
 {
-	if (!ItemGrid.IsValid()) return;
+	if (!ItemTileView.IsValid()) return;
 
-	ItemGrid->ClearChildren();
-	
-	const FMargin SlotPadding = FMargin(10.0f);
+	SlotEntries.Reset();
 	
 	if (InventoryComponent.IsValid())
 	{
 		const TArray<FInventoryItem>& Items = InventoryComponent->GetItems();
-		int32 Col = 0;
-		int32 Row = 0;
+		SlotEntries.Reserve(Items.Num());
 
 		for (const FInventoryItem& Item : Items)
 		{
-			ItemGrid->AddSlot(Col, Row)
-				.Padding(SlotPadding)
-				[
-					CreateItemSlotWidget(&Item)
-				];
+			FInventorySlotEntryPtr Entry = MakeShared<FInventorySlotEntry>();
+			Entry->ItemDef = Item.ItemDef;
+			Entry->Quantity = Item.Quantity;
+			SlotEntries.Add(Entry);
+		}
+	}
+
+	// Only the tiles that end up visible are generated
+	ItemTileView->RebuildList();
+}
 
-			Col++;
-			if (Col > 2)
+void SInventoryWidget::ApplyChanges(const FInventoryChangeSet& ChangeSet)
+{
+	if (!ItemTileView.IsValid()) return;
+
+	bool bLayoutChanged = false;
+
+	// Indices are only meaningful relative to the previous state, so replay the changes in order
+	for (const FInventoryChange& Change : ChangeSet.Changes)
+	{
+		switch (Change.Type)
+		{
+		case EInventoryChangeType::Added:
+		{
+			if (Change.Index != SlotEntries.Num())
+			{
+				// out of sync with the component, start over from its current state
+				RefreshList();
+				return;
+			}
+
+			FInventorySlotEntryPtr Entry = MakeShared<FInventorySlotEntry>();
+			Entry->ItemDef = Change.ItemDef;
+			Entry->Quantity = Change.Quantity;
+			SlotEntries.Add(Entry);
+			bLayoutChanged = true;
+			break;
+		}
+
+		case EInventoryChangeType::QuantityChanged:
+		{
+			if (!SlotEntries.IsValidIndex(Change.Index))
+			{
+				RefreshList();
+				return;
+			}
+
+			// the tile reads this through an attribute, so no widget needs to be touched
+			SlotEntries[Change.Index]->Quantity = Change.Quantity;
+			break;
+		}
+
+		case EInventoryChangeType::Removed:
+		{
+			if (!SlotEntries.IsValidIndex(Change.Index))
 			{
-				Col = 0;
-				Row++;
+				RefreshList();
+				return;
 			}
+
+			// mirror the component's swap-remove, the moved entry keeps its tile
+			SlotEntries.RemoveAtSwap(Change.Index, 1, EAllowShrinking::No);
+			bLayoutChanged = true;
+			break;
+		}
 		}
+	}
 
-		// Fill remaining empty slots up to minimal row/cols if needed
-		// For now, just showing held items
+	if (bLayoutChanged)
+	{
+		ItemTileView->RequestListRefresh();
+	}
+}
+
+const FText& SInventoryWidget::FInventorySlotEntry::GetQuantityText()
+{
+	if (QuantityTextValue != Quantity)
+	{
+		QuantityText = MakeQuantityText(Quantity);
+		QuantityTextValue = Quantity;
 	}
+
+	return QuantityText;
 }
 
+TSharedRef<ITableRow> SInventoryWidget::GenerateItemTile(FInventorySlotEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	const FMargin SlotPadding = FMargin(10.0f);
+	TWeakPtr<FInventorySlotEntry> WeakEntry = Entry;
+	TWeakPtr<FInventoryIconCache> WeakIconCache = IconCache;
+	const TWeakObjectPtr<const UItemDefinition> ItemDef = Entry->ItemDef;
+
+	// tiles are only generated for visible entries, so this is what drives icon streaming
+	IconCache->RequestIcon(ItemDef.Get());
+
+	return SNew(STableRow<FInventorySlotEntryPtr>, OwnerTable)
+		.Padding(SlotPadding)
+		.ShowSelection(false)
+		[
+			CreateItemSlotWidget(ItemDef.Get(), TAttribute<FText>::CreateLambda([WeakEntry]()
+			{
+				const TSharedPtr<FInventorySlotEntry> PinnedEntry = WeakEntry.Pin();
+				return PinnedEntry.IsValid() ? PinnedEntry->GetQuantityText() : FText::GetEmpty();
+			}),
+			TAttribute<const FSlateBrush*>::CreateLambda([WeakIconCache, ItemDef]() -> const FSlateBrush*
+			{
+				const TSharedPtr<FInventoryIconCache> PinnedCache = WeakIconCache.Pin();
+				return PinnedCache.IsValid() ? PinnedCache->GetIconBrush(ItemDef.Get()) : nullptr;
+			}))
+		];
+}
+
+void SInventoryWidget::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	// icons requested by tiles generated this frame are loaded as one batch
+	if (IconCache.IsValid())
+	{
+		IconCache->FlushRequests();
+	}
+}
+
+float SInventoryWidget::GetTileWidth() const
+{
+	// leave room for the scrollbar so the columns never wrap
+	const float ScrollbarAllowance = 16.0f;
+	const float ViewWidth = ItemTileView.IsValid() ? ItemTileView->GetCachedGeometry().GetLocalSize().X : 0.0f;
+
+	return ViewWidth > 0.0f ? FMath::Max(1.0f, ViewWidth / InventoryGridColumns - ScrollbarAllowance) : 200.0f;
+}
 
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
+
+SInventoryWidget::~SInventoryWidget()
+{
+	if (InventoryComponent.IsValid())
+	{
+		InventoryComponent->OnInventoryChanged.Remove(InventoryChangedHandle);
+	}
+}
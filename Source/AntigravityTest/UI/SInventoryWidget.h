@@ -4,6 +4,13 @@
 #include "Widgets/SCompoundWidget.h"
 #include "Widgets/DeclarativeSyntaxSupport.h"
 
+class ITableRow;
+class STableViewBase;
+template <typename ItemType> class STileView;
+struct FInventoryChangeSet;
+class UItemDefinition;
+class FInventoryIconCache;
+
 /**
  * 
  */
@@ -11,17 +18,52 @@ class ANTIGRAVITYTEST_API SInventoryWidget : public SCompoundWidget
 {
 public:
 	SLATE_BEGIN_ARGS(SInventoryWidget)
+		: _UseIconAtlas(true)
 	{}
 		SLATE_ARGUMENT(TWeakObjectPtr<class UInventoryComponent>, InventoryComponent)
+		// Packs streamed item icons into one runtime atlas texture
+		SLATE_ARGUMENT(bool, UseIconAtlas)
 	SLATE_END_ARGS()
 
 	/** Constructs this widget with InArgs */
 	void Construct(const FArguments& InArgs);
 
+	virtual ~SInventoryWidget();
+
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+
 	// Refreshes the item list from the component
 	void RefreshList();
 
 private:
+	// View-side copy of one inventory slot. Tiles are generated only for visible entries and keyed by this pointer
+	struct FInventorySlotEntry
+	{
+		TWeakObjectPtr<const UItemDefinition> ItemDef;
+		int32 Quantity = 0;
+
+		// Formatted lazily so entries that are never scrolled into view cost no text work
+		const FText& GetQuantityText();
+
+	private:
+		FText QuantityText;
+		int32 QuantityTextValue = INDEX_NONE;
+	};
+
+	using FInventorySlotEntryPtr = TSharedPtr<FInventorySlotEntry>;
+
+	// Patches only the entries touched by ChangeSet
+	void ApplyChanges(const FInventoryChangeSet& ChangeSet);
+
+	// Generates the tile widget for a visible entry
+	TSharedRef<ITableRow> GenerateItemTile(FInventorySlotEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable);
+
+	// Sizes tiles so the view keeps a fixed number of columns
+	float GetTileWidth() const;
+
 	TWeakObjectPtr<class UInventoryComponent> InventoryComponent;
-	TSharedPtr<class SGridPanel> ItemGrid;
+	TSharedPtr<STileView<FInventorySlotEntryPtr>> ItemTileView;
+	TArray<FInventorySlotEntryPtr> SlotEntries;
+	TSharedPtr<FInventoryIconCache> IconCache;
+	FDelegateHandle InventoryChangedHandle;
 };
@@ -24,4 +24,7 @@ public:
 
 	/** Constructor */
 	ACombatAIController();
+
+	/** Returns the StateTree component */
+	UStateTreeAIComponent* GetStateTreeAI() const { return StateTreeAI; }
 };
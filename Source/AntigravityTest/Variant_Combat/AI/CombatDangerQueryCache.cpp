@@ -0,0 +1,329 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDangerQueryCache.h"
+#include "EnvironmentQuery/EnvQuery.h"
+#include "EnvironmentQuery/EnvQueryManager.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static TAutoConsoleVariable<bool> CVarCombatDangerQueryCacheEnabled(
+	TEXT("Combat.DangerQueryCache.Enabled"),
+	true,
+	TEXT("If true, enemies share the results of danger avoidance queries instead of each running their own."));
+
+static TAutoConsoleVariable<float> CVarCombatDangerQueryCacheCellSize(
+	TEXT("Combat.DangerQueryCache.CellSize"),
+	200.0f,
+	TEXT("Size of the grid danger locations are quantized to. Requests in the same cell share a query."));
+
+static TAutoConsoleVariable<float> CVarCombatDangerQueryCacheTTL(
+	TEXT("Combat.DangerQueryCache.TTL"),
+	0.5f,
+	TEXT("Seconds shared danger query results are kept for."));
+
+static TAutoConsoleVariable<float> CVarCombatDangerQueryCacheBudgetMs(
+	TEXT("Combat.DangerQueryCache.BudgetMs"),
+	1.0f,
+	TEXT("Milliseconds per frame the cache may spend running queued danger queries. At least one query is always run."));
+
+UCombatDangerQueryCache* UCombatDangerQueryCache::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatDangerQueryCacheEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatDangerQueryCache>();
+}
+
+bool UCombatDangerQueryCache::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatDangerQueryCache::Deinitialize()
+{
+	Queries.Empty();
+	Requests.Empty();
+	PendingKeys.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatDangerQueryCache::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDangerQueryCache, STATGROUP_Tickables);
+}
+
+UCombatDangerQueryCache::FQueryKey UCombatDangerQueryCache::MakeKey(const UEnvQuery* QueryTemplate, const FVector& DangerLocation) const
+{
+	const double CellSize = FMath::Max(1.0f, CVarCombatDangerQueryCacheCellSize.GetValueOnGameThread());
+
+	FQueryKey Key;
+	Key.Template = QueryTemplate;
+	Key.Cell = FIntVector(
+		FMath::FloorToInt32(DangerLocation.X / CellSize),
+		FMath::FloorToInt32(DangerLocation.Y / CellSize),
+		FMath::FloorToInt32(DangerLocation.Z / CellSize));
+
+	return Key;
+}
+
+int32 UCombatDangerQueryCache::RequestQuery(UEnvQuery* QueryTemplate, AActor* Querier, const FVector& DangerLocation, const FCombatDangerQueryFilter& Filter)
+{
+	if (!QueryTemplate || !IsValid(Querier))
+	{
+		return INDEX_NONE;
+	}
+
+	const FQueryKey Key = MakeKey(QueryTemplate, DangerLocation);
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// start a new shared query if there is none for this key, or its results went stale
+	FCachedQuery& Query = Queries.FindOrAdd(Key);
+	const bool bQueued = !Query.bReady && Query.Leader.IsValid();
+
+	if (!bQueued && (!Query.bReady || Now >= Query.ExpireTime))
+	{
+		Query = FCachedQuery();
+		Query.Template = QueryTemplate;
+		Query.Leader = Querier;
+		Query.DangerLocation = DangerLocation;
+
+		PendingKeys.AddUnique(Key);
+	}
+
+	const int32 RequestId = NextRequestId++;
+
+	FQueryRequest& Request = Requests.Add(RequestId);
+	Request.Key = Key;
+	Request.Querier = Querier;
+	Request.Filter = Filter;
+
+	// fresh results can be handed out right away
+	if (Query.bReady)
+	{
+		ResolveRequest(Request, Query);
+	}
+
+	return RequestId;
+}
+
+ECombatDangerQueryStatus UCombatDangerQueryCache::GetQueryStatus(int32 RequestId, FVector& OutLocation) const
+{
+	const FQueryRequest* Request = Requests.Find(RequestId);
+	if (!Request)
+	{
+		return ECombatDangerQueryStatus::Invalid;
+	}
+
+	OutLocation = Request->Location;
+	return Request->Status;
+}
+
+void UCombatDangerQueryCache::ReleaseQuery(int32 RequestId)
+{
+	Requests.Remove(RequestId);
+}
+
+bool UCombatDangerQueryCache::GetRunningDangerLocation(const UObject* Querier, FVector& OutDangerLocation) const
+{
+	if (Querier && RunningQuerier.Get() == Querier)
+	{
+		OutDangerLocation = RunningDangerLocation;
+		return true;
+	}
+
+	return false;
+}
+
+void UCombatDangerQueryCache::Tick(float DeltaTime)
+{
+	// drop requests from queriers that went away without releasing them
+	for (auto It = Requests.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().Querier.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// evict expired results
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	for (auto It = Queries.CreateIterator(); It; ++It)
+	{
+		if (It.Value().bReady && Now >= It.Value().ExpireTime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	if (PendingKeys.IsEmpty())
+	{
+		return;
+	}
+
+	const double BudgetSeconds = CVarCombatDangerQueryCacheBudgetMs.GetValueOnGameThread() * 0.001;
+	const double StartTime = FPlatformTime::Seconds();
+
+	int32 Processed = 0;
+
+	while (!PendingKeys.IsEmpty())
+	{
+		// always get through at least one query so the queue can't stall
+		if (Processed > 0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+
+		const FQueryKey Key = PendingKeys[0];
+		PendingKeys.RemoveAt(0, 1, EAllowShrinking::No);
+
+		FCachedQuery* Query = Queries.Find(Key);
+		if (!Query || Query->bReady)
+		{
+			continue;
+		}
+
+		if (!RunQuery(Key, *Query))
+		{
+			Queries.Remove(Key);
+			continue;
+		}
+
+		++Processed;
+	}
+}
+
+bool UCombatDangerQueryCache::RunQuery(const FQueryKey& Key, FCachedQuery& Query)
+{
+	UEnvQueryManager* QueryManager = UEnvQueryManager::GetCurrent(GetWorld());
+	UEnvQuery* QueryTemplate = Query.Template.Get();
+
+	// if the leader went away, run the query for anyone else waiting on it
+	AActor* Leader = Query.Leader.Get();
+	if (!Leader)
+	{
+		for (const TPair<int32, FQueryRequest>& Pair : Requests)
+		{
+			if (Pair.Value.Key == Key && Pair.Value.Querier.IsValid())
+			{
+				Leader = Pair.Value.Querier.Get();
+				break;
+			}
+		}
+	}
+
+	if (!QueryManager || !QueryTemplate || !Leader)
+	{
+		// fail everyone waiting on it
+		for (TPair<int32, FQueryRequest>& Pair : Requests)
+		{
+			if (Pair.Value.Key == Key && Pair.Value.Status == ECombatDangerQueryStatus::Pending)
+			{
+				Pair.Value.Status = ECombatDangerQueryStatus::Failed;
+			}
+		}
+
+		return false;
+	}
+
+	// run the query against the shared danger location instead of the leader's latest one
+	RunningQuerier = Leader;
+	RunningDangerLocation = Query.DangerLocation;
+
+	FEnvQueryRequest QueryRequest(QueryTemplate, Leader);
+	TSharedPtr<FEnvQueryResult> Result = QueryManager->RunInstantQuery(QueryRequest, EEnvQueryRunMode::AllMatching);
+
+	RunningQuerier.Reset();
+
+	// keep every scored item, best first, so each querier can pick its own
+	if (Result.IsValid() && Result->IsSuccessful())
+	{
+		Query.Locations.Reserve(Result->Items.Num());
+		Query.Scores.Reserve(Result->Items.Num());
+
+		for (int32 ItemIndex = 0; ItemIndex < Result->Items.Num(); ++ItemIndex)
+		{
+			Query.Locations.Add(Result->GetItemAsLocation(ItemIndex));
+			Query.Scores.Add(Result->GetItemScore(ItemIndex));
+		}
+	}
+
+	Query.bReady = true;
+	Query.ExpireTime = GetWorld()->GetTimeSeconds() + CVarCombatDangerQueryCacheTTL.GetValueOnGameThread();
+
+	// hand out results to everyone waiting
+	for (TPair<int32, FQueryRequest>& Pair : Requests)
+	{
+		if (Pair.Value.Key == Key && Pair.Value.Status == ECombatDangerQueryStatus::Pending)
+		{
+			ResolveRequest(Pair.Value, Query);
+		}
+	}
+
+	return true;
+}
+
+void UCombatDangerQueryCache::ResolveRequest(FQueryRequest& Request, FCachedQuery& Query) const
+{
+	const AActor* Querier = Request.Querier.Get();
+	if (!Querier)
+	{
+		Request.Status = ECombatDangerQueryStatus::Failed;
+		return;
+	}
+
+	const FVector QuerierLocation = Querier->GetActorLocation();
+	const FCombatDangerQueryFilter& Filter = Request.Filter;
+	const float MaxDistanceSquared = FMath::Square(Filter.MaxDistance);
+	const float ClaimRadiusSquared = FMath::Square(Filter.ClaimRadius);
+
+	int32 BestIndex = INDEX_NONE;
+	float BestScore = -UE_MAX_FLT;
+
+	for (int32 ItemIndex = 0; ItemIndex < Query.Locations.Num(); ++ItemIndex)
+	{
+		const FVector& Location = Query.Locations[ItemIndex];
+
+		// skip results out of the querier's reach
+		const float DistanceSquared = FVector::DistSquared(Location, QuerierLocation);
+		if (DistanceSquared > MaxDistanceSquared)
+		{
+			continue;
+		}
+
+		// skip results another querier already took
+		const bool bClaimed = Query.ClaimedLocations.ContainsByPredicate([&Location, ClaimRadiusSquared](const FVector& Claimed)
+		{
+			return FVector::DistSquared(Location, Claimed) < ClaimRadiusSquared;
+		});
+
+		if (bClaimed)
+		{
+			continue;
+		}
+
+		// rescore the shared result for this querier, preferring closer locations
+		const float Score = Query.Scores[ItemIndex] - Filter.DistanceWeight * FMath::Sqrt(DistanceSquared) / FMath::Max(1.0f, Filter.MaxDistance);
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestIndex = ItemIndex;
+		}
+	}
+
+	if (BestIndex == INDEX_NONE)
+	{
+		Request.Status = ECombatDangerQueryStatus::Failed;
+		return;
+	}
+
+	Request.Status = ECombatDangerQueryStatus::Succeeded;
+	Request.Location = Query.Locations[BestIndex];
+
+	Query.ClaimedLocations.Add(Request.Location);
+}
@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "CombatDangerQueryCache.generated.h"
+
+class UEnvQuery;
+
+/**
+ *  State of a danger query request
+ */
+enum class ECombatDangerQueryStatus : uint8
+{
+	/** Unknown or released request */
+	Invalid,
+
+	/** Waiting for its shared query to run */
+	Pending,
+
+	/** A location was picked for the querier */
+	Succeeded,
+
+	/** The query failed or no result passed the querier's filter */
+	Failed
+};
+
+/**
+ *  Per-querier filter applied to the shared results of a danger query
+ */
+struct FCombatDangerQueryFilter
+{
+	/** Results further than this from the querier are skipped */
+	float MaxDistance = 1500.0f;
+
+	/** Results this close to a location already handed to another querier are skipped, so groups spread out */
+	float ClaimRadius = 150.0f;
+
+	/** How much distance from the querier counts against a result's score, per MaxDistance travelled */
+	float DistanceWeight = 0.5f;
+};
+
+/**
+ *  World subsystem that shares the results of danger avoidance EQS queries between enemies.
+ *  Queries are keyed by query template and danger location quantized to a grid, so a group of enemies reacting to
+ *  the same attack run a single query. Results are kept for a short time and filtered for each querier, which
+ *  picks the best result close to itself that no other querier has claimed yet.
+ *  New queries are queued and run within a global time budget per frame.
+ */
+UCLASS()
+class UCombatDangerQueryCache : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Identifies a shared query */
+	struct FQueryKey
+	{
+		/** Query template to run */
+		TObjectKey<UEnvQuery> Template;
+
+		/** Danger location, quantized to the cache grid */
+		FIntVector Cell = FIntVector::ZeroValue;
+
+		bool operator==(const FQueryKey& Other) const
+		{
+			return Template == Other.Template && Cell == Other.Cell;
+		}
+
+		friend uint32 GetTypeHash(const FQueryKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Template), GetTypeHash(Key.Cell));
+		}
+	};
+
+	/** A shared query and its results */
+	struct FCachedQuery
+	{
+		/** Query template to run */
+		TWeakObjectPtr<UEnvQuery> Template;
+
+		/** Querier the query runs for. Its danger location is used for everyone sharing the query */
+		TWeakObjectPtr<AActor> Leader;
+
+		/** Danger location the query runs against */
+		FVector DangerLocation = FVector::ZeroVector;
+
+		/** Result locations, best first */
+		TArray<FVector> Locations;
+
+		/** Result scores, matching Locations */
+		TArray<float> Scores;
+
+		/** Locations already handed out to queriers */
+		TArray<FVector> ClaimedLocations;
+
+		/** Game time the results expire at */
+		double ExpireTime = 0.0;
+
+		/** True once the query has run */
+		bool bReady = false;
+	};
+
+	/** A querier waiting on or holding a shared query */
+	struct FQueryRequest
+	{
+		/** Shared query the request reads from */
+		FQueryKey Key;
+
+		/** Actor that made the request */
+		TWeakObjectPtr<AActor> Querier;
+
+		/** Filter applied to the shared results */
+		FCombatDangerQueryFilter Filter;
+
+		/** Current state */
+		ECombatDangerQueryStatus Status = ECombatDangerQueryStatus::Pending;
+
+		/** Location picked for the querier */
+		FVector Location = FVector::ZeroVector;
+	};
+
+public:
+
+	/** Returns the cache for the given world, or nullptr if it is disabled */
+	static UCombatDangerQueryCache* Get(const UWorld* World);
+
+	/** Only create the cache for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Drops all queries and requests */
+	virtual void Deinitialize() override;
+
+	/** Evicts expired results and runs queued queries within this frame's budget */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Requests a location from the shared query for a template and danger location. Returns the request ID, or INDEX_NONE on bad input */
+	int32 RequestQuery(UEnvQuery* QueryTemplate, AActor* Querier, const FVector& DangerLocation, const FCombatDangerQueryFilter& Filter = FCombatDangerQueryFilter());
+
+	/** Returns the state of a request, and the picked location if it succeeded */
+	ECombatDangerQueryStatus GetQueryStatus(int32 RequestId, FVector& OutLocation) const;
+
+	/** Drops a request once its querier is done with it */
+	void ReleaseQuery(int32 RequestId);
+
+	/** Returns the danger location of the shared query currently running for a querier, for the danger EQS context */
+	bool GetRunningDangerLocation(const UObject* Querier, FVector& OutDangerLocation) const;
+
+	/** Returns the number of cached or queued queries */
+	int32 GetNumCachedQueries() const { return Queries.Num(); }
+
+	/** Returns the number of queries waiting to run */
+	int32 GetNumPendingQueries() const { return PendingKeys.Num(); }
+
+protected:
+
+	/** Quantizes a request into its shared query key */
+	FQueryKey MakeKey(const UEnvQuery* QueryTemplate, const FVector& DangerLocation) const;
+
+	/** Runs a queued query and resolves the requests waiting on it. Returns false if nobody could run it */
+	bool RunQuery(const FQueryKey& Key, FCachedQuery& Query);
+
+	/** Picks a location from the shared results for a request */
+	void ResolveRequest(FQueryRequest& Request, FCachedQuery& Query) const;
+
+	/** Shared queries, by key */
+	TMap<FQueryKey, FCachedQuery> Queries;
+
+	/** Requests, by ID */
+	TMap<int32, FQueryRequest> Requests;
+
+	/** Keys of queries waiting to run, oldest first */
+	TArray<FQueryKey> PendingKeys;
+
+	/** Querier of the query being run, if any */
+	TWeakObjectPtr<const AActor> RunningQuerier;
+
+	/** Danger location of the query being run */
+	FVector RunningDangerLocation = FVector::ZeroVector;
+
+	/** Next request ID to hand out */
+	int32 NextRequestId = 0;
+};
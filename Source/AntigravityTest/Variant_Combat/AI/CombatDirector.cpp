@@ -0,0 +1,188 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDirector.h"
+#include "CombatEnemy.h"
+#include "CombatEnemySpawner.h"
+#include "CombatEnemyPool.h"
+#include "AI/PlayerPerceptionCache.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static TAutoConsoleVariable<bool> CVarCombatDirectorEnabled(
+	TEXT("Combat.Director.Enabled"),
+	true,
+	TEXT("If true, enemy spawners queue their waves with the combat director instead of spawning immediately."));
+
+static TAutoConsoleVariable<int32> CVarCombatDirectorMaxSpawnsPerFrame(
+	TEXT("Combat.Director.MaxSpawnsPerFrame"),
+	2,
+	TEXT("Maximum number of spawn or prewarm requests the combat director processes in a single frame."));
+
+static TAutoConsoleVariable<float> CVarCombatDirectorSpawnBudgetMs(
+	TEXT("Combat.Director.SpawnBudgetMs"),
+	2.0f,
+	TEXT("Milliseconds per frame the combat director may spend spawning. At least one request is always processed."));
+
+static TAutoConsoleVariable<int32> CVarCombatDirectorMaxLiveEnemies(
+	TEXT("Combat.Director.MaxLiveEnemies"),
+	24,
+	TEXT("Maximum number of live enemies. Spawn requests wait in the queue while the cap is reached."));
+
+UCombatDirector* UCombatDirector::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatDirectorEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatDirector>();
+}
+
+bool UCombatDirector::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatDirector::Deinitialize()
+{
+	Requests.Empty();
+	LiveEnemies.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatDirector::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDirector, STATGROUP_Tickables);
+}
+
+void UCombatDirector::QueueRequests(ACombatEnemySpawner* Spawner, ECombatSpawnRequestType Type, int32 Count)
+{
+	if (!IsValid(Spawner))
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		FSpawnRequest& Request = Requests.AddDefaulted_GetRef();
+		Request.Spawner = Spawner;
+		Request.Type = Type;
+		Request.Sequence = NextSequence++;
+	}
+}
+
+void UCombatDirector::CancelRequests(ACombatEnemySpawner* Spawner)
+{
+	Requests.RemoveAll([Spawner](const FSpawnRequest& Request)
+	{
+		return Request.Spawner.Get() == Spawner;
+	});
+}
+
+void UCombatDirector::PruneLiveEnemies()
+{
+	LiveEnemies.RemoveAllSwap([](const TWeakObjectPtr<ACombatEnemy>& Enemy)
+	{
+		return !Enemy.IsValid() || Enemy->CurrentHP <= 0.0f;
+	}, EAllowShrinking::No);
+}
+
+void UCombatDirector::Tick(float DeltaTime)
+{
+	PruneLiveEnemies();
+
+	if (Requests.IsEmpty())
+	{
+		return;
+	}
+
+	// find the player. Without one, all spawners are equally important
+	FVector PlayerLocation = FVector::ZeroVector;
+	if (UPlayerPerceptionCache* PerceptionCache = UPlayerPerceptionCache::Get(GetWorld()))
+	{
+		PlayerLocation = PerceptionCache->GetPlayerLocation(0);
+	}
+	else if (const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		if (const APawn* PlayerPawn = PlayerController->GetPawn())
+		{
+			PlayerLocation = PlayerPawn->GetActorLocation();
+		}
+	}
+
+	// refresh the priorities and drop requests from spawners that went away
+	for (int32 RequestIndex = Requests.Num() - 1; RequestIndex >= 0; --RequestIndex)
+	{
+		FSpawnRequest& Request = Requests[RequestIndex];
+		if (const ACombatEnemySpawner* Spawner = Request.Spawner.Get())
+		{
+			Request.DistanceSquared = FVector::DistSquared(Spawner->GetActorLocation(), PlayerLocation);
+		}
+		else
+		{
+			Requests.RemoveAt(RequestIndex, 1, EAllowShrinking::No);
+		}
+	}
+
+	// spawns before prewarms, then closest spawner first, then oldest request first
+	Requests.Sort([](const FSpawnRequest& A, const FSpawnRequest& B)
+	{
+		if (A.Type != B.Type)
+		{
+			return A.Type == ECombatSpawnRequestType::Spawn;
+		}
+
+		if (A.DistanceSquared != B.DistanceSquared)
+		{
+			return A.DistanceSquared < B.DistanceSquared;
+		}
+
+		return A.Sequence < B.Sequence;
+	});
+
+	const int32 MaxSpawnsPerFrame = FMath::Max(1, CVarCombatDirectorMaxSpawnsPerFrame.GetValueOnGameThread());
+	const double BudgetSeconds = CVarCombatDirectorSpawnBudgetMs.GetValueOnGameThread() * 0.001;
+	const int32 MaxLiveEnemies = CVarCombatDirectorMaxLiveEnemies.GetValueOnGameThread();
+	const double StartTime = FPlatformTime::Seconds();
+
+	int32 Processed = 0;
+	int32 RequestIndex = 0;
+
+	while (RequestIndex < Requests.Num() && Processed < MaxSpawnsPerFrame)
+	{
+		// always get through at least one request so the queue can't stall
+		if (Processed > 0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+
+		const FSpawnRequest Request = Requests[RequestIndex];
+		ACombatEnemySpawner* Spawner = Request.Spawner.Get();
+
+		if (Request.Type == ECombatSpawnRequestType::Spawn)
+		{
+			// spawns wait in the queue while we're at the live cap, but prewarms further down can still run
+			if (LiveEnemies.Num() >= MaxLiveEnemies)
+			{
+				++RequestIndex;
+				continue;
+			}
+
+			if (ACombatEnemy* Enemy = Spawner->SpawnQueuedEnemy())
+			{
+				LiveEnemies.Add(Enemy);
+			}
+		}
+		else if (UCombatEnemyPool* EnemyPool = UCombatEnemyPool::Get(GetWorld()))
+		{
+			EnemyPool->Prewarm(Spawner->GetEnemyClass(), 1, Spawner->GetSpawnTransform());
+		}
+
+		Requests.RemoveAt(RequestIndex, 1, EAllowShrinking::No);
+		++Processed;
+	}
+}
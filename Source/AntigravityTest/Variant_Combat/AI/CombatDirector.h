@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatDirector.generated.h"
+
+class ACombatEnemy;
+class ACombatEnemySpawner;
+
+/**
+ *  Kind of work a spawner can queue with the combat director
+ */
+enum class ECombatSpawnRequestType : uint8
+{
+	/** Spawn or reactivate a live enemy */
+	Spawn,
+
+	/** Add a dormant enemy to the enemy pool */
+	Prewarm
+};
+
+/**
+ *  World subsystem that schedules enemy spawns across all spawners.
+ *  Spawners queue their waves here instead of spawning directly. Each frame the director works through the queue,
+ *  closest spawners to the player first, within a spawn count and time budget and under a global cap of live enemies.
+ *  This spreads out large encounters where several spawners activate in the same frame.
+ */
+UCLASS()
+class UCombatDirector : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A single queued unit of spawn work */
+	struct FSpawnRequest
+	{
+		/** Spawner that asked for the work */
+		TWeakObjectPtr<ACombatEnemySpawner> Spawner;
+
+		/** What to do */
+		ECombatSpawnRequestType Type = ECombatSpawnRequestType::Spawn;
+
+		/** Squared distance from the spawner to the player, refreshed every frame */
+		double DistanceSquared = 0.0;
+
+		/** Order the request was queued in, to keep sorting stable */
+		uint32 Sequence = 0;
+	};
+
+public:
+
+	/** Returns the director for the given world, or nullptr if it is disabled */
+	static UCombatDirector* Get(const UWorld* World);
+
+	/** Only create the director for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Drops all queued work */
+	virtual void Deinitialize() override;
+
+	/** Works through the queue within this frame's budget */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Queues a number of spawn or prewarm requests for a spawner */
+	void QueueRequests(ACombatEnemySpawner* Spawner, ECombatSpawnRequestType Type, int32 Count);
+
+	/** Drops every queued request for a spawner */
+	void CancelRequests(ACombatEnemySpawner* Spawner);
+
+	/** Returns the number of live enemies spawned through the director */
+	int32 GetNumLiveEnemies() const { return LiveEnemies.Num(); }
+
+	/** Returns the number of queued requests */
+	int32 GetNumQueuedRequests() const { return Requests.Num(); }
+
+protected:
+
+	/** Drops live enemies that died or were removed */
+	void PruneLiveEnemies();
+
+	/** Queued spawn work */
+	TArray<FSpawnRequest> Requests;
+
+	/** Enemies spawned through the director that are still alive */
+	TArray<TWeakObjectPtr<ACombatEnemy>> LiveEnemies;
+
+	/** Running request counter */
+	uint32 NextSequence = 0;
+};
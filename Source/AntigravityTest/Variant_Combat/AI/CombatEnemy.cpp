@@ -9,6 +9,17 @@
 #include "Engine/DamageEvents.h"
 #include "CombatLifeBar.h"
 #include "TimerManager.h"
+#include "CombatTargetRegistry.h"
+#include "CombatAttackTraceQueue.h"
+#include "CombatDangerEventBus.h"
+#include "CombatEnemyPool.h"
+#include "CombatRagdollBudget.h"
+#include "CombatHitReactionScheduler.h"
+#include "CombatLifeBarRenderer.h"
+#include "CombatSceneQueryCounter.h"
+#include "Components/StateTreeAIComponent.h"
+#include "AI/AISignificanceManager.h"
+#include "Component/AnimNotifyRouterComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimInstance.h"
 
@@ -32,6 +43,13 @@ ACombatEnemy::ACombatEnemy()
 	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
 	LifeBar->SetupAttachment(RootComponent);
 
+	// route gameplay notifies from our mesh straight to the attacker handlers
+	NotifyRouter = CreateDefaultSubobject<UAnimNotifyRouterComponent>(TEXT("NotifyRouter"));
+	NotifyRouter->SetMesh(GetMesh());
+	NotifyRouter->SetRouteHandler(EAnimNotifyRoute::AttackTrace, FAnimNotifyRouteHandler::CreateUObject(this, &ACombatEnemy::DoAttackTrace));
+	NotifyRouter->SetRouteHandler(EAnimNotifyRoute::CheckCombo, FAnimNotifyRouteHandler::CreateWeakLambda(this, [this](FName) { CheckCombo(); }));
+	NotifyRouter->SetRouteHandler(EAnimNotifyRoute::CheckChargedAttack, FAnimNotifyRouteHandler::CreateWeakLambda(this, [this](FName) { CheckChargedAttack(); }));
+
 	// set the collision capsule size
 	GetCapsuleComponent()->SetCapsuleSize(35.0f, 90.0f);
 
@@ -125,9 +143,6 @@ float ACombatEnemy::GetLastDangerTime() const
 
 void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 {
-	// sweep for objects in front of the character to be hit by the attack
-	TArray<FHitResult> OutHits;
-
 	// start at the provided socket location, sweep forward
 	const FVector TraceStart = GetMesh()->GetSocketLocation(DamageSourceBone);
 	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * MeleeTraceDistance);
@@ -136,6 +151,16 @@ void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 	FCollisionObjectQueryParams ObjectParams;
 	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
 
+	// defer the trace to the batched queue if it's available. Hits come back through ResolveAttackTrace
+	if (UCombatAttackTraceQueue* TraceQueue = UCombatAttackTraceQueue::Get(GetWorld()))
+	{
+		TraceQueue->EnqueueTrace(this, TraceStart, TraceEnd, MeleeTraceRadius, ObjectParams);
+		return;
+	}
+
+	// sweep for objects in front of the character to be hit by the attack
+	TArray<FHitResult> OutHits;
+
 	// use a sphere shape for the sweep
 	FCollisionShape CollisionShape;
 	CollisionShape.SetSphere(MeleeTraceRadius);
@@ -144,26 +169,38 @@ void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
-	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
+	// use the target registry when it's available, otherwise fall back to a physics sweep
+	if (const UCombatTargetRegistry* TargetRegistry = UCombatTargetRegistry::Get(GetWorld()))
 	{
-		// iterate over each object hit
-		for (const FHitResult& CurrentHit : OutHits)
-		{
-			/** does the actor have the player tag? */
-			if (CurrentHit.GetActor()->ActorHasTag(FName("Player")))
-			{
-				// check if the actor is damageable
-				ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
+		TargetRegistry->SweepDamageables(TraceStart, TraceEnd, MeleeTraceRadius, ObjectParams, this, OutHits);
+	}
+	else
+	{
+		GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams);
+		CountCombatSceneQueries();
+	}
+
+	ResolveAttackTrace(OutHits);
+}
 
-				if (Damageable)
-				{
-					// knock upwards and away from the impact normal
-					const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+void ACombatEnemy::ResolveAttackTrace(const TArray<FHitResult>& Hits)
+{
+	// iterate over each object hit
+	for (const FHitResult& CurrentHit : Hits)
+	{
+		/** does the actor have the player tag? */
+		if (CurrentHit.GetActor() && CurrentHit.GetActor()->ActorHasTag(FName("Player")))
+		{
+			// check if the actor is damageable
+			ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
 
-					// pass the damage event to the actor
-					Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+			if (Damageable)
+			{
+				// knock upwards and away from the impact normal
+				const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
 
-				}
+				// pass the damage event to the actor
+				Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
 			}
 		}
 	}
@@ -207,6 +244,12 @@ void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 	// only process knockback and effects if we received nonzero damage
 	if (ActualDamage > 0.0f)
 	{
+		// run at full rate while the knockback plays out
+		if (UAISignificanceManager* SignificanceManager = GetWorld()->GetSubsystem<UAISignificanceManager>())
+		{
+			SignificanceManager->PromoteAgent(this);
+		}
+
 		// apply the knockback impulse
 		GetCharacterMovement()->AddImpulse(DamageImpulse, true);
 
@@ -234,14 +277,42 @@ void ACombatEnemy::HandleDeath()
 	// hide the life bar
 	LifeBar->SetHiddenInGame(true);
 
+	if (UCombatLifeBarRenderer* LifeBarRenderer = GetWorld()->GetSubsystem<UCombatLifeBarRenderer>())
+	{
+		LifeBarRenderer->RemoveLifeBar(this);
+	}
+
 	// disable the collision capsule to avoid being hit again while dead
 	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
 	// disable character movement
 	GetCharacterMovement()->DisableMovement();
 
-	// enable full ragdoll physics
-	GetMesh()->SetSimulatePhysics(true);
+	// the death takes over from any hit reaction in progress
+	if (UCombatHitReactionScheduler* HitReactions = GetWorld()->GetSubsystem<UCombatHitReactionScheduler>())
+	{
+		HitReactions->CancelHitReaction(GetMesh());
+	}
+
+	// enable full ragdoll physics if the ragdoll budget allows it, otherwise fall back to a cheaper death
+	if (UCombatRagdollBudget* RagdollBudget = UCombatRagdollBudget::Get(GetWorld()))
+	{
+		// if our ragdoll is later evicted mid-flight, blend to the fallback death instead of freezing in the air
+		if (!RagdollBudget->TryStartRagdoll(GetMesh(), FSimpleDelegate::CreateUObject(this, &ACombatEnemy::PlayFallbackDeath)))
+		{
+			PlayFallbackDeath();
+		}
+	}
+	else
+	{
+		GetMesh()->SetSimulatePhysics(true);
+	}
+
+	// dead enemies don't react to danger
+	if (UCombatDangerEventBus* DangerBus = UCombatDangerEventBus::Get(GetWorld()))
+	{
+		DangerBus->UnregisterListener(this);
+	}
 
 	// call the died delegate to notify any subscribers
 	OnEnemyDied.Broadcast();
@@ -250,6 +321,36 @@ void ACombatEnemy::HandleDeath()
 	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &ACombatEnemy::RemoveFromLevel, DeathRemovalTime);
 }
 
+void ACombatEnemy::PlayFallbackDeath()
+{
+	// drop any partial ragdoll from the last hit
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+
+	// play the baked death animation
+	if (DeathMontage && AnimInstance && AnimInstance->Montage_Play(DeathMontage) > 0.0f)
+	{
+		return;
+	}
+
+	// no death animation, so just hold the current pose
+	GetMesh()->bPauseAnims = true;
+}
+
+void ACombatEnemy::SetLifeBarPercentage(float Percent)
+{
+	if (!bUseBatchedLifeBar)
+	{
+		LifeBarWidget->SetLifePercentage(Percent);
+	}
+	else if (UCombatLifeBarRenderer* LifeBarRenderer = GetWorld()->GetSubsystem<UCombatLifeBarRenderer>())
+	{
+		LifeBarRenderer->SetLifePercentage(this, Percent);
+	}
+}
+
 void ACombatEnemy::ApplyHealing(float Healing, AActor* Healer)
 {
 	// stub
@@ -263,15 +364,180 @@ void ACombatEnemy::NotifyDanger(const FVector& DangerLocation, AActor* DangerSou
 		// save the danger location and game time
 		LastDangerLocation = DangerLocation;
 		LastDangerTime = GetWorld()->GetTimeSeconds();
+
+		// also tell the StateTree. Trees that transition on this event don't need to poll the danger condition,
+		// ST_CombatEnemy still polls "Character is in Danger" for its reaction window
+		if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+		{
+			if (UStateTreeAIComponent* StateTreeAI = AIController->GetStateTreeAI())
+			{
+				StateTreeAI->SendStateTreeEvent(TAG_Combat_Event_Danger, FConstStructView(), DangerSource->GetFName());
+			}
+		}
 	}
 }
 
 void ACombatEnemy::RemoveFromLevel()
 {
+	// pooled enemies go back to sleep so they can be reused
+	if (UCombatEnemyPool* Pool = OwningPool.Get())
+	{
+		Pool->ReleaseEnemy(this);
+		return;
+	}
+
 	// destroy this actor
 	Destroy();
 }
 
+void ACombatEnemy::SetOwningPool(UCombatEnemyPool* Pool)
+{
+	OwningPool = Pool;
+}
+
+void ACombatEnemy::DeactivateForPool()
+{
+	// clear the death timer in case we were released early
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// drop the previous spawner's subscription
+	OnEnemyDied.Clear();
+
+	// restore full tick rates before we stop ticking altogether
+	if (UAISignificanceManager* SignificanceManager = GetWorld()->GetSubsystem<UAISignificanceManager>())
+	{
+		SignificanceManager->UnregisterAgent(this);
+	}
+
+	// dormant enemies don't react to danger
+	if (UCombatDangerEventBus* DangerBus = UCombatDangerEventBus::Get(GetWorld()))
+	{
+		DangerBus->UnregisterListener(this);
+	}
+
+	// stop the StateTree
+	if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+	{
+		if (UStateTreeAIComponent* StateTreeAI = AIController->GetStateTreeAI())
+		{
+			StateTreeAI->StopLogic(TEXT("Pooled"));
+		}
+	}
+
+	// stop any attack in progress
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	// zero HP so stray hits on the dormant enemy are ignored
+	CurrentHP = 0.0f;
+
+	// stop moving
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+
+	// turn the ragdoll off and snap the mesh back under the capsule
+	if (UCombatRagdollBudget* RagdollBudget = GetWorld()->GetSubsystem<UCombatRagdollBudget>())
+	{
+		RagdollBudget->ReleaseRagdoll(GetMesh());
+	}
+
+	if (UCombatHitReactionScheduler* HitReactions = GetWorld()->GetSubsystem<UCombatHitReactionScheduler>())
+	{
+		HitReactions->CancelHitReaction(GetMesh());
+	}
+
+	GetMesh()->bPauseAnims = false;
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	GetMesh()->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+
+	// hide the enemy and take it out of collision and ticking
+	LifeBar->SetHiddenInGame(true);
+
+	// the batched life bar doesn't know we're hidden, so stop drawing it until we're reactivated
+	if (UCombatLifeBarRenderer* LifeBarRenderer = GetWorld()->GetSubsystem<UCombatLifeBarRenderer>())
+	{
+		LifeBarRenderer->RemoveLifeBar(this);
+	}
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+}
+
+void ACombatEnemy::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	// move to the spawn point
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// reset HP to maximum
+	CurrentHP = MaxHP;
+
+	// reset the attack and danger state
+	bIsAttacking = false;
+	TargetComboCount = 0;
+	CurrentComboAttack = 0;
+	TargetChargeLoops = 0;
+	CurrentChargeLoop = 0;
+	LastDangerLocation = FVector::ZeroVector;
+	LastDangerTime = -1000.0f;
+
+	// restore the capsule collision that was disabled on death
+	const ACombatEnemy* DefaultEnemy = GetClass()->GetDefaultObject<ACombatEnemy>();
+	GetCapsuleComponent()->SetCollisionEnabled(DefaultEnemy->GetCapsuleComponent()->GetCollisionEnabled());
+
+	// show the enemy and bring back collision and ticking
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	GetMesh()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+
+	// start moving again
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	// show and fill the life bar
+	LifeBar->SetHiddenInGame(false);
+
+	if (bUseBatchedLifeBar)
+	{
+		if (UCombatLifeBarRenderer* LifeBarRenderer = GetWorld()->GetSubsystem<UCombatLifeBarRenderer>())
+		{
+			LifeBarRenderer->AddLifeBar(this, LifeBar, LifeBarColor);
+		}
+	}
+	else if (LifeBarWidget)
+	{
+		LifeBarWidget->SetLifePercentage(1.0f);
+	}
+
+	// listen for incoming attacks
+	if (UCombatDangerEventBus* DangerBus = UCombatDangerEventBus::Get(GetWorld()))
+	{
+		DangerBus->RegisterListener(this);
+	}
+
+	// scale our tick rates by distance to the player
+	if (UAISignificanceManager* SignificanceManager = GetWorld()->GetSubsystem<UAISignificanceManager>())
+	{
+		SignificanceManager->RegisterAgent(this);
+	}
+
+	// restart the StateTree now that HP and location are valid
+	if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+	{
+		if (UStateTreeAIComponent* StateTreeAI = AIController->GetStateTreeAI())
+		{
+			StateTreeAI->StartLogic();
+		}
+	}
+}
+
 float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	// only process damage if the character is still alive
@@ -292,11 +558,18 @@ float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEv
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+		SetLifeBarPercentage(CurrentHP / MaxHP);
 
 		// enable partial ragdoll physics, but keep the pelvis vertical
-		GetMesh()->SetPhysicsBlendWeight(0.5f);
-		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		if (UCombatHitReactionScheduler* HitReactions = UCombatHitReactionScheduler::Get(GetWorld()))
+		{
+			HitReactions->AddHitReaction(GetMesh(), PelvisBoneName, 0.5f);
+		}
+		else
+		{
+			GetMesh()->SetPhysicsBlendWeight(0.5f);
+			GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		}
 	}
 
 	// return the received damage amount
@@ -307,8 +580,8 @@ void ACombatEnemy::Landed(const FHitResult& Hit)
 {
 	Super::Landed(Hit);
 
-	// is the character still alive?
-	if (CurrentHP >= 0.0f)
+	// is the character still alive? The hit reaction scheduler blends the partial ragdoll out on its own
+	if (CurrentHP >= 0.0f && !UCombatHitReactionScheduler::Get(GetWorld()))
 	{
 		// disable ragdoll physics
 		GetMesh()->SetPhysicsBlendWeight(0.0f);
@@ -332,6 +605,28 @@ void ACombatEnemy::BeginPlay()
 
 	// fill the life bar
 	LifeBarWidget->SetLifePercentage(1.0f);
+
+	// let the batched renderer draw our life bar, and stop drawing the widget
+	if (UCombatLifeBarRenderer* LifeBarRenderer = UCombatLifeBarRenderer::Get(GetWorld()))
+	{
+		bUseBatchedLifeBar = true;
+		LifeBarRenderer->AddLifeBar(this, LifeBar, LifeBarColor);
+
+		LifeBar->SetVisibility(false);
+		LifeBar->SetComponentTickEnabled(false);
+	}
+
+	// listen for incoming attacks
+	if (UCombatDangerEventBus* DangerBus = UCombatDangerEventBus::Get(GetWorld()))
+	{
+		DangerBus->RegisterListener(this);
+	}
+
+	// scale our tick rates by distance to the player
+	if (UAISignificanceManager* SignificanceManager = GetWorld()->GetSubsystem<UAISignificanceManager>())
+	{
+		SignificanceManager->RegisterAgent(this);
+	}
 }
 
 void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -340,4 +635,34 @@ void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// stop listening for incoming attacks
+	if (UCombatDangerEventBus* DangerBus = GetWorld()->GetSubsystem<UCombatDangerEventBus>())
+	{
+		DangerBus->UnregisterListener(this);
+	}
+
+	// stop scaling our tick rates
+	if (UAISignificanceManager* SignificanceManager = GetWorld()->GetSubsystem<UAISignificanceManager>())
+	{
+		SignificanceManager->UnregisterAgent(this);
+	}
+
+	// free up our ragdoll slot
+	if (UCombatRagdollBudget* RagdollBudget = GetWorld()->GetSubsystem<UCombatRagdollBudget>())
+	{
+		RagdollBudget->ReleaseRagdoll(GetMesh());
+	}
+
+	// stop any hit reaction
+	if (UCombatHitReactionScheduler* HitReactions = GetWorld()->GetSubsystem<UCombatHitReactionScheduler>())
+	{
+		HitReactions->CancelHitReaction(GetMesh());
+	}
+
+	// stop drawing our life bar
+	if (UCombatLifeBarRenderer* LifeBarRenderer = GetWorld()->GetSubsystem<UCombatLifeBarRenderer>())
+	{
+		LifeBarRenderer->RemoveLifeBar(this);
+	}
 }
@@ -13,6 +13,8 @@
 class UWidgetComponent;
 class UCombatLifeBar;
 class UAnimMontage;
+class UCombatEnemyPool;
+class UAnimNotifyRouterComponent;
 
 /** Completed attack animation delegate for StateTree */
 DECLARE_DELEGATE(FOnEnemyAttackCompleted);
@@ -36,6 +38,10 @@ class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDa
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UWidgetComponent* LifeBar;
 
+	/** Routes gameplay anim notifies from the mesh without casting */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UAnimNotifyRouterComponent* NotifyRouter;
+
 public:
 	
 	/** Constructor */
@@ -63,6 +69,13 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	UCombatLifeBar* LifeBarWidget;
 
+	/** Life bar fill color, used when life bars are drawn by the batched life bar renderer */
+	UPROPERTY(EditAnywhere, Category="Damage")
+	FLinearColor LifeBarColor = FLinearColor(0.8f, 0.05f, 0.05f);
+
+	/** If true, our life bar is drawn by the batched life bar renderer instead of the widget component */
+	bool bUseBatchedLifeBar = false;
+
 	/** If true, the character is currently playing an attack animation */
 	bool bIsAttacking = false;
 
@@ -133,6 +146,10 @@ protected:
 	/** Enemy death timer */
 	FTimerHandle DeathTimer;
 
+	/** Baked death animation played instead of a ragdoll when the ragdoll budget is full or we die off-screen. If unset, the current pose is frozen instead */
+	UPROPERTY(EditAnywhere, Category="Death")
+	UAnimMontage* DeathMontage;
+
 	/** Attack montage ended delegate */
 	FOnMontageEnded OnAttackMontageEnded;
 
@@ -142,6 +159,9 @@ protected:
 	/** Last recorded game time we were attacked */
 	float LastDangerTime = -1000.0f;
 
+	/** Pool this enemy returns to when it's removed from the level. Unpooled enemies are destroyed instead */
+	TWeakObjectPtr<UCombatEnemyPool> OwningPool;
+
 public:
 	/** Attack completed internal delegate to notify StateTree tasks */
 	FOnEnemyAttackCompleted OnAttackCompleted;
@@ -185,6 +205,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Attacker")
 	virtual void CheckChargedAttack() override;
 
+	/** Applies damage to the targets hit by an attack trace */
+	virtual void ResolveAttackTrace(const TArray<FHitResult>& Hits) override;
+
 	// ~end ICombatAttacker interface
 
 	// ~begin ICombatDamageable interface
@@ -208,6 +231,23 @@ protected:
 	/** Removes this character from the level after it dies */
 	void RemoveFromLevel();
 
+	/** Plays the death montage, or freezes the current pose, when we don't get a ragdoll */
+	void PlayFallbackDeath();
+
+	/** Updates the life bar, either through the batched renderer or the widget */
+	void SetLifeBarPercentage(float Percent);
+
+public:
+
+	/** Sets the pool this enemy will return to instead of being destroyed */
+	void SetOwningPool(UCombatEnemyPool* Pool);
+
+	/** Puts the enemy to sleep so it can wait in a pool: hides it, stops its logic, ticking and collision, and resets its ragdoll */
+	void DeactivateForPool();
+
+	/** Wakes up a pooled enemy at the given transform with full HP and restarts its StateTree */
+	void ActivateFromPool(const FTransform& SpawnTransform);
+
 public:
 
 	/** Overrides the default TakeDamage functionality */
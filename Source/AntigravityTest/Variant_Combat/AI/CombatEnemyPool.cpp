@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnemyPool.h"
+#include "CombatEnemy.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarCombatEnemyPoolEnabled(
+	TEXT("Combat.EnemyPool.Enabled"),
+	true,
+	TEXT("If true, enemy spawners reuse dormant enemies from a pool instead of spawning and destroying them."));
+
+UCombatEnemyPool* UCombatEnemyPool::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatEnemyPoolEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatEnemyPool>();
+}
+
+bool UCombatEnemyPool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatEnemyPool::Deinitialize()
+{
+	Buckets.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCombatEnemyPool::Prewarm(TSubclassOf<ACombatEnemy> EnemyClass, int32 Count, const FTransform& SpawnTransform)
+{
+	if (!IsValid(EnemyClass))
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		ACombatEnemy* Enemy = SpawnPooledEnemy(EnemyClass, SpawnTransform);
+		if (!Enemy)
+		{
+			return;
+		}
+
+		// park it right away
+		Enemy->DeactivateForPool();
+		Buckets.FindOrAdd(EnemyClass).DormantEnemies.Add(Enemy);
+	}
+}
+
+ACombatEnemy* UCombatEnemyPool::AcquireEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform)
+{
+	if (!IsValid(EnemyClass))
+	{
+		return nullptr;
+	}
+
+	// reuse the most recently parked enemy if we have one
+	if (FCombatEnemyPoolBucket* Bucket = Buckets.Find(EnemyClass))
+	{
+		while (!Bucket->DormantEnemies.IsEmpty())
+		{
+			ACombatEnemy* Enemy = Bucket->DormantEnemies.Pop(EAllowShrinking::No);
+			if (IsValid(Enemy))
+			{
+				Enemy->ActivateFromPool(SpawnTransform);
+				return Enemy;
+			}
+		}
+	}
+
+	// the pool ran dry, so pay for a full spawn. The enemy will come back to the pool when it's removed
+	return SpawnPooledEnemy(EnemyClass, SpawnTransform);
+}
+
+void UCombatEnemyPool::ReleaseEnemy(ACombatEnemy* Enemy)
+{
+	if (!IsValid(Enemy))
+	{
+		return;
+	}
+
+	Enemy->DeactivateForPool();
+	Buckets.FindOrAdd(Enemy->GetClass()).DormantEnemies.AddUnique(Enemy);
+}
+
+int32 UCombatEnemyPool::GetNumDormant(TSubclassOf<ACombatEnemy> EnemyClass) const
+{
+	const FCombatEnemyPoolBucket* Bucket = Buckets.Find(EnemyClass);
+	return Bucket ? Bucket->DormantEnemies.Num() : 0;
+}
+
+ACombatEnemy* UCombatEnemyPool::SpawnPooledEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform) const
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	ACombatEnemy* Enemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnTransform, SpawnParams);
+	if (Enemy)
+	{
+		Enemy->SetOwningPool(const_cast<UCombatEnemyPool*>(this));
+	}
+
+	return Enemy;
+}
@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatEnemyPool.generated.h"
+
+class ACombatEnemy;
+
+/**
+ *  Dormant enemies of a single class
+ */
+USTRUCT()
+struct FCombatEnemyPoolBucket
+{
+	GENERATED_BODY()
+
+	/** Enemies waiting to be reused */
+	UPROPERTY()
+	TArray<TObjectPtr<ACombatEnemy>> DormantEnemies;
+};
+
+/**
+ *  World subsystem that keeps dormant, pre-spawned combat enemies around so they can be reused.
+ *  Reusing an enemy skips actor construction, component registration, AI controller spawning and StateTree setup,
+ *  and dead enemies are returned to the pool instead of being destroyed and garbage collected.
+ */
+UCLASS()
+class UCombatEnemyPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Returns the pool for the given world, or nullptr if pooling is disabled */
+	static UCombatEnemyPool* Get(const UWorld* World);
+
+	/** Only create the pool for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Drops all dormant enemies */
+	virtual void Deinitialize() override;
+
+	/** Spawns Count dormant enemies of the given class and adds them to the pool */
+	void Prewarm(TSubclassOf<ACombatEnemy> EnemyClass, int32 Count, const FTransform& SpawnTransform);
+
+	/** Reactivates a dormant enemy at the given transform, or spawns a new one if the pool is empty */
+	ACombatEnemy* AcquireEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform);
+
+	/** Deactivates an enemy and keeps it for reuse */
+	void ReleaseEnemy(ACombatEnemy* Enemy);
+
+	/** Returns the number of dormant enemies of the given class */
+	int32 GetNumDormant(TSubclassOf<ACombatEnemy> EnemyClass) const;
+
+protected:
+
+	/** Spawns a new enemy owned by this pool */
+	ACombatEnemy* SpawnPooledEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform) const;
+
+	/** Dormant enemies, per class */
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FCombatEnemyPoolBucket> Buckets;
+};
@@ -8,6 +8,8 @@
 #include "Components/ArrowComponent.h"
 #include "TimerManager.h"
 #include "CombatEnemy.h"
+#include "CombatEnemyPool.h"
+#include "CombatDirector.h"
 
 ACombatEnemySpawner::ACombatEnemySpawner()
 {
@@ -31,12 +33,15 @@ ACombatEnemySpawner::ACombatEnemySpawner()
 void ACombatEnemySpawner::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// prewarm the pool on the first frame, once every actor in the level has begun play
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ACombatEnemySpawner::PrewarmEnemyPool);
 	
 	// should we spawn an enemy right away?
 	if (bShouldSpawnEnemiesImmediately)
 	{
-		// schedule the first enemy spawn
-		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, InitialSpawnDelay);
+		// schedule the first wave
+		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnWave, InitialSpawnDelay);
 	}
 
 }
@@ -47,32 +52,104 @@ void ACombatEnemySpawner::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the spawn timer
 	GetWorld()->GetTimerManager().ClearTimer(SpawnTimer);
+
+	// drop anything still waiting in the director's queue
+	if (UCombatDirector* Director = GetWorld()->GetSubsystem<UCombatDirector>())
+	{
+		Director->CancelRequests(this);
+	}
+}
+
+void ACombatEnemySpawner::PrewarmEnemyPool()
+{
+	// let the director spread the prewarm spawns over several frames
+	if (UCombatDirector* Director = UCombatDirector::Get(GetWorld()))
+	{
+		Director->QueueRequests(this, ECombatSpawnRequestType::Prewarm, PoolPrewarmCount);
+		return;
+	}
+
+	if (UCombatEnemyPool* EnemyPool = UCombatEnemyPool::Get(GetWorld()))
+	{
+		EnemyPool->Prewarm(EnemyClass, PoolPrewarmCount, SpawnCapsule->GetComponentTransform());
+	}
+}
+
+FTransform ACombatEnemySpawner::GetSpawnTransform() const
+{
+	return SpawnCapsule->GetComponentTransform();
+}
+
+void ACombatEnemySpawner::SpawnWave()
+{
+	// don't spawn more enemies than we have left
+	const int32 WaveCount = FMath::Min(WaveSize, SpawnCount - EnemiesAlive - EnemiesQueued);
+	if (WaveCount <= 0)
+	{
+		return;
+	}
+
+	// queue the wave with the director so it can budget the spawns
+	if (UCombatDirector* Director = UCombatDirector::Get(GetWorld()))
+	{
+		EnemiesQueued += WaveCount;
+		Director->QueueRequests(this, ECombatSpawnRequestType::Spawn, WaveCount);
+		return;
+	}
+
+	// spawn the whole wave right away
+	for (int32 i = 0; i < WaveCount; ++i)
+	{
+		SpawnEnemy();
+	}
+}
+
+ACombatEnemy* ACombatEnemySpawner::SpawnQueuedEnemy()
+{
+	EnemiesQueued = FMath::Max(0, EnemiesQueued - 1);
+
+	return SpawnEnemy();
 }
 
-void ACombatEnemySpawner::SpawnEnemy()
+ACombatEnemy* ACombatEnemySpawner::SpawnEnemy()
 {
+	ACombatEnemy* SpawnedEnemy = nullptr;
+
 	// ensure the enemy class is valid
 	if (IsValid(EnemyClass))
 	{
-		// spawn the enemy at the reference capsule's transform
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		// reuse a dormant enemy from the pool if it's available
+		if (UCombatEnemyPool* EnemyPool = UCombatEnemyPool::Get(GetWorld()))
+		{
+			SpawnedEnemy = EnemyPool->AcquireEnemy(EnemyClass, SpawnCapsule->GetComponentTransform());
+		}
+		else
+		{
+			// spawn the enemy at the reference capsule's transform
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
 
-		ACombatEnemy* SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+			SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+		}
 
 		// was the enemy successfully created?
 		if (SpawnedEnemy)
 		{
 			// subscribe to the death delegate
 			SpawnedEnemy->OnEnemyDied.AddDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
+
+			++EnemiesAlive;
 		}
 	}
+
+	return SpawnedEnemy;
 }
 
 void ACombatEnemySpawner::OnEnemyDied()
 {
-	// decrease the spawn counter
+	// decrease the spawn and alive counters
 	--SpawnCount;
+	EnemiesAlive = FMath::Max(0, EnemiesAlive - 1);
 
 	// is this the last enemy we should spawn?
 	if (SpawnCount <= 0)
@@ -82,8 +159,14 @@ void ACombatEnemySpawner::OnEnemyDied()
 		return;
 	}
 
-	// schedule the next enemy spawn
-	GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, RespawnDelay);
+	// wait until the whole wave is gone
+	if (EnemiesAlive > 0 || EnemiesQueued > 0)
+	{
+		return;
+	}
+
+	// schedule the next wave
+	GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnWave, RespawnDelay);
 }
 
 void ACombatEnemySpawner::SpawnerDepleted()
@@ -116,8 +199,8 @@ void ACombatEnemySpawner::ActivateInteraction(AActor* ActivationInstigator)
 	// raise the activation flag
 	bHasBeenActivated = true;
 
-	// spawn the first enemy
-	SpawnEnemy();
+	// spawn the first wave
+	SpawnWave();
 }
 
 void ACombatEnemySpawner::DeactivateInteraction(AActor* ActivationInstigator)
@@ -13,7 +13,8 @@ class ACombatEnemy;
 
 /**
  *  A basic Actor in charge of spawning Enemy Characters and monitoring their deaths.
- *  Enemies will be spawned one by one, and the spawner will wait until the enemy dies before spawning a new one.
+ *  Enemies will be spawned in waves, and the spawner will wait until the whole wave dies before spawning a new one.
+ *  When the combat director is available, waves are queued with it instead of being spawned immediately
  *  The spawner can be remotely activated through the ICombatActivatable interface
  *  When the last spawned enemy dies, the spawner can also activate other ICombatActivatables
  */
@@ -46,10 +47,18 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 100))
 	int32 SpawnCount = 1;
 
-	/** Time to wait before spawning the next enemy after the current one dies */
+	/** Number of enemies spawned together in each wave */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 1, ClampMax = 20))
+	int32 WaveSize = 1;
+
+	/** Time to wait before spawning the next wave after the current one dies */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 10))
 	float RespawnDelay = 5.0f;
 
+	/** Number of dormant enemies this spawner adds to the enemy pool on level load, so spawning doesn't pay for actor construction */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner|Pooling", meta = (ClampMin = 0, ClampMax = 100))
+	int32 PoolPrewarmCount = 2;
+
 	/** Time to wait after this spawner is depleted before activating the actor list */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Activation", meta = (ClampMin = 0, ClampMax = 10))
 	float ActivationDelay = 1.0f;
@@ -64,6 +73,12 @@ protected:
 	/** Timer to spawn enemies after a delay */
 	FTimerHandle SpawnTimer;
 
+	/** Number of spawned enemies that are still alive */
+	int32 EnemiesAlive = 0;
+
+	/** Number of enemies waiting in the combat director's queue */
+	int32 EnemiesQueued = 0;
+
 public:	
 	
 	/** Constructor */
@@ -79,8 +94,14 @@ public:
 
 protected:
 
+	/** Fills the enemy pool with dormant enemies of our class */
+	void PrewarmEnemyPool();
+
+	/** Starts a new wave, either through the combat director or by spawning the enemies right away */
+	void SpawnWave();
+
 	/** Spawn an enemy and subscribe to its death event */
-	void SpawnEnemy();
+	ACombatEnemy* SpawnEnemy();
 
 	/** Called when the spawned enemy has died */
 	UFUNCTION()
@@ -89,6 +110,17 @@ protected:
 	/** Called after the last spawned enemy has died */
 	void SpawnerDepleted();
 
+public:
+
+	/** Spawns one of the enemies queued with the combat director. Called by the director when its budget allows */
+	ACombatEnemy* SpawnQueuedEnemy();
+
+	/** Returns the type of enemy to spawn */
+	TSubclassOf<ACombatEnemy> GetEnemyClass() const { return EnemyClass; }
+
+	/** Returns the transform enemies are spawned at */
+	FTransform GetSpawnTransform() const;
+
 public:
 
 	// ~begin ICombatActivatable interface
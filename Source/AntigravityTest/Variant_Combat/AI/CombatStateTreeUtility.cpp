@@ -11,6 +11,9 @@
 #include "CombatEnemy.h"
 #include "Kismet/GameplayStatics.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "AI/PlayerPerceptionCache.h"
+#include "CombatDangerQueryCache.h"
+#include "EnvironmentQuery/EnvQueryManager.h"
 
 bool FStateTreeCharacterGroundedCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
@@ -33,7 +36,7 @@ FText FStateTreeCharacterGroundedCondition::GetDescription(const FGuid& ID, FSta
 
 bool FStateTreeIsInDangerCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
-	const FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	// ensure we have a valid enemy character
 	if (InstanceData.Character)
@@ -47,9 +50,15 @@ bool FStateTreeIsInDangerCondition::TestCondition(FStateTreeExecutionContext& Co
 			const FVector DangerDir = (InstanceData.Character->GetLastDangerLocation() - InstanceData.Character->GetActorLocation()).GetSafeNormal2D();
 
 			const float DangerDot = FVector::DotProduct(DangerDir, InstanceData.Character->GetActorForwardVector());
-			const float ConeAngleCos = FMath::Cos(FMath::DegreesToRadians(InstanceData.DangerSightConeAngle));
 
-			return DangerDot > ConeAngleCos;
+			// the cone angle rarely changes, so only recompute its cosine when it does
+			if (InstanceData.CachedConeAngle != InstanceData.DangerSightConeAngle)
+			{
+				InstanceData.CachedConeAngle = InstanceData.DangerSightConeAngle;
+				InstanceData.CachedConeAngleCos = FMath::Cos(FMath::DegreesToRadians(InstanceData.DangerSightConeAngle));
+			}
+
+			return DangerDot > InstanceData.CachedConeAngleCos;
 		}
 	}
 
@@ -301,6 +310,27 @@ EStateTreeRunStatus FStateTreeGetPlayerInfoTask::Tick(FStateTreeExecutionContext
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
+	// read the shared per-frame player snapshot if it's available
+	if (UPlayerPerceptionCache* PerceptionCache = UPlayerPerceptionCache::Get(InstanceData.Character->GetWorld()))
+	{
+		InstanceData.TargetPlayerCharacter = Cast<ACharacter>(PerceptionCache->GetPlayerPawn(0));
+
+		// do we have a valid target?
+		if (InstanceData.TargetPlayerCharacter)
+		{
+			// update the last known location and read the batched distance
+			InstanceData.TargetPlayerLocation = PerceptionCache->GetPlayerLocation(0);
+			InstanceData.DistanceToTarget = FMath::Sqrt(PerceptionCache->GetDistanceSquaredToPlayer(InstanceData.Character));
+		}
+		else
+		{
+			// measure against the last known location
+			InstanceData.DistanceToTarget = FVector::Distance(InstanceData.TargetPlayerLocation, InstanceData.Character->GetActorLocation());
+		}
+
+		return EStateTreeRunStatus::Running;
+	}
+
 	// get the character possessed by the first local player
 	InstanceData.TargetPlayerCharacter = Cast<ACharacter>(UGameplayStatics::GetPlayerPawn(InstanceData.Character, 0));
 
@@ -322,4 +352,103 @@ FText FStateTreeGetPlayerInfoTask::GetDescription(const FGuid& ID, FStateTreeDat
 {
 	return FText::FromString("<b>Get Player Info</b>");
 }
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+EStateTreeRunStatus FStateTreeFindDangerEscapeTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	if (!InstanceData.Character || !InstanceData.QueryTemplate)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// share the query with every other enemy escaping the same danger
+	if (UCombatDangerQueryCache* QueryCache = UCombatDangerQueryCache::Get(InstanceData.Character->GetWorld()))
+	{
+		FCombatDangerQueryFilter Filter;
+		Filter.MaxDistance = InstanceData.MaxDistance;
+		Filter.ClaimRadius = InstanceData.ClaimRadius;
+
+		// the rest of the request goes through this cache only, whatever the CVar does meanwhile
+		InstanceData.QueryCache = QueryCache;
+
+		QueryCache->ReleaseQuery(InstanceData.RequestId);
+		InstanceData.RequestId = QueryCache->RequestQuery(InstanceData.QueryTemplate, InstanceData.Character, InstanceData.Character->GetLastDangerLocation(), Filter);
+
+		// the results may already be cached
+		return Tick(Context, 0.0f);
+	}
+
+	// otherwise run our own query
+	UEnvQueryManager* QueryManager = UEnvQueryManager::GetCurrent(InstanceData.Character->GetWorld());
+	if (!QueryManager)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	FEnvQueryRequest QueryRequest(InstanceData.QueryTemplate, InstanceData.Character);
+	TSharedPtr<FEnvQueryResult> Result = QueryManager->RunInstantQuery(QueryRequest, EEnvQueryRunMode::SingleResult);
+
+	if (!Result.IsValid() || !Result->IsSuccessful() || Result->Items.IsEmpty())
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	InstanceData.EscapeLocation = Result->GetItemAsLocation(0);
+	return EStateTreeRunStatus::Succeeded;
+}
+
+EStateTreeRunStatus FStateTreeFindDangerEscapeTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	UCombatDangerQueryCache* QueryCache = InstanceData.QueryCache.Get();
+	if (!QueryCache)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// wait for the shared query to run
+	switch (QueryCache->GetQueryStatus(InstanceData.RequestId, InstanceData.EscapeLocation))
+	{
+	case ECombatDangerQueryStatus::Pending:
+		return EStateTreeRunStatus::Running;
+
+	case ECombatDangerQueryStatus::Succeeded:
+		QueryCache->ReleaseQuery(InstanceData.RequestId);
+		InstanceData.RequestId = INDEX_NONE;
+		return EStateTreeRunStatus::Succeeded;
+
+	default:
+		QueryCache->ReleaseQuery(InstanceData.RequestId);
+		InstanceData.RequestId = INDEX_NONE;
+		return EStateTreeRunStatus::Failed;
+	}
+}
+
+void FStateTreeFindDangerEscapeTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	// drop any request still waiting with the cache it was made with
+	if (UCombatDangerQueryCache* QueryCache = InstanceData.QueryCache.Get())
+	{
+		QueryCache->ReleaseQuery(InstanceData.RequestId);
+	}
+
+	InstanceData.RequestId = INDEX_NONE;
+	InstanceData.QueryCache.Reset();
+}
+
+#if WITH_EDITOR
+FText FStateTreeFindDangerEscapeTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Find Danger Escape Location</b>");
+}
 #endif // WITH_EDITOR
\ No newline at end of file
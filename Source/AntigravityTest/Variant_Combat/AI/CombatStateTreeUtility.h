@@ -11,6 +11,8 @@
 class ACharacter;
 class AAIController;
 class ACombatEnemy;
+class UEnvQuery;
+class UCombatDangerQueryCache;
 
 /**
  *  Instance data struct for the FStateTreeCharacterGroundedCondition condition
@@ -81,6 +83,12 @@ struct FStateTreeIsInDangerConditionInstanceData
 	/** Line of sight half angle for detecting incoming danger, in degrees*/
 	UPROPERTY(EditAnywhere, Category = "Parameters", meta = (Units = "degrees"))
 	float DangerSightConeAngle = 120.0f;
+
+	/** Cone angle the cached cosine was computed for */
+	float CachedConeAngle = -1.0f;
+
+	/** Cosine of the cone angle, recomputed only when the angle changes */
+	float CachedConeAngleCos = 1.0f;
 };
 STATETREE_POD_INSTANCEDATA(FStateTreeIsInDangerConditionInstanceData);
 
@@ -359,6 +367,70 @@ struct FStateTreeGetPlayerInfoTask : public FStateTreeTaskCommonBase
 	/** Runs while the owning state is active */
 	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
 
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
+
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Find Danger Escape Location task
+ */
+USTRUCT()
+struct FStateTreeFindDangerEscapeInstanceData
+{
+	GENERATED_BODY()
+
+	/** Character that is escaping the danger */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<ACombatEnemy> Character;
+
+	/** EQS query that scores escape locations around the danger context */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	TObjectPtr<UEnvQuery> QueryTemplate;
+
+	/** Shared results further than this from the character are ignored */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (Units = "cm"))
+	float MaxDistance = 1500.0f;
+
+	/** Shared results this close to a location another enemy already picked are ignored */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (Units = "cm"))
+	float ClaimRadius = 150.0f;
+
+	/** Location the character should escape to */
+	UPROPERTY(VisibleAnywhere)
+	FVector EscapeLocation = FVector::ZeroVector;
+
+	/** Request held with the danger query cache */
+	int32 RequestId = INDEX_NONE;
+
+	/** Cache the request was made with, so toggling the cache off mid-state doesn't orphan it */
+	TWeakObjectPtr<UCombatDangerQueryCache> QueryCache;
+};
+
+/**
+ *  StateTree task to find a location away from the character's last danger.
+ *  Enemies reacting to the same attack share one query through the danger query cache.
+ */
+USTRUCT(meta=(DisplayName="Find Danger Escape Location", Category="Combat"))
+struct FStateTreeFindDangerEscapeTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeFindDangerEscapeInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Runs while the owning state is active */
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
 #if WITH_EDITOR
 	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
 #endif // WITH_EDITOR
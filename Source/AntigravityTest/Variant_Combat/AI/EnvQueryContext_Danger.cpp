@@ -3,11 +3,23 @@
 
 #include "Variant_Combat/AI/EnvQueryContext_Danger.h"
 #include "Variant_Combat/AI/CombatEnemy.h"
+#include "Variant_Combat/AI/CombatDangerQueryCache.h"
 #include "EnvironmentQuery/EnvQueryTypes.h"
 #include "EnvironmentQuery/Items/EnvQueryItemType_Point.h"
 
 void UEnvQueryContext_Danger::ProvideContext(FEnvQueryInstance& QueryInstance, FEnvQueryContextData& ContextData) const
 {
+	// shared queries run against the danger location they were cached for
+	if (const UCombatDangerQueryCache* QueryCache = UCombatDangerQueryCache::Get(QueryInstance.World))
+	{
+		FVector SharedDangerLocation;
+		if (QueryCache->GetRunningDangerLocation(QueryInstance.Owner.Get(), SharedDangerLocation))
+		{
+			UEnvQueryItemType_Point::SetContextHelper(ContextData, SharedDangerLocation);
+			return;
+		}
+	}
+
 	// get the querying enemy
 	if (ACombatEnemy* QuerierActor = Cast<ACombatEnemy>(QueryInstance.Owner.Get()))
 	{
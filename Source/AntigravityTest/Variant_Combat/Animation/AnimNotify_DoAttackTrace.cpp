@@ -4,9 +4,16 @@
 #include "AnimNotify_DoAttackTrace.h"
 #include "CombatAttacker.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Component/AnimNotifyRouterComponent.h"
 
 void UAnimNotify_DoAttackTrace::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
 {
+	// use the handler cached by the owner's notify router if it has one
+	if (UAnimNotifyRouterComponent::RouteNotify(MeshComp, EAnimNotifyRoute::AttackTrace, AttackBoneName))
+	{
+		return;
+	}
+
 	// cast the owner to the attacker interface
 	if (ICombatAttacker* AttackerInterface = Cast<ICombatAttacker>(MeshComp->GetOwner()))
 	{
@@ -13,6 +13,13 @@
 #include "CombatLifeBar.h"
 #include "Engine/DamageEvents.h"
 #include "TimerManager.h"
+#include "CombatTargetRegistry.h"
+#include "CombatAttackTraceQueue.h"
+#include "CombatDangerEventBus.h"
+#include "CombatLifeBarRenderer.h"
+#include "CombatSceneQueryCounter.h"
+#include "Component/InputBufferComponent.h"
+#include "Component/AnimNotifyRouterComponent.h"
 #include "Engine/LocalPlayer.h"
 #include "CombatPlayerController.h"
 
@@ -47,6 +54,17 @@ ACombatCharacter::ACombatCharacter()
 	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
 	LifeBar->SetupAttachment(RootComponent);
 
+	// create the input buffer and route replayed inputs to the input handlers
+	InputBuffer = CreateDefaultSubobject<UInputBufferComponent>(TEXT("InputBuffer"));
+	InputBuffer->OnReplayInput.AddUObject(this, &ACombatCharacter::HandleReplayedInput);
+
+	// route gameplay notifies from our mesh straight to the attacker handlers
+	NotifyRouter = CreateDefaultSubobject<UAnimNotifyRouterComponent>(TEXT("NotifyRouter"));
+	NotifyRouter->SetMesh(GetMesh());
+	NotifyRouter->SetRouteHandler(EAnimNotifyRoute::AttackTrace, FAnimNotifyRouteHandler::CreateUObject(this, &ACombatCharacter::DoAttackTrace));
+	NotifyRouter->SetRouteHandler(EAnimNotifyRoute::CheckCombo, FAnimNotifyRouteHandler::CreateWeakLambda(this, [this](FName) { CheckCombo(); }));
+	NotifyRouter->SetRouteHandler(EAnimNotifyRoute::CheckChargedAttack, FAnimNotifyRouteHandler::CreateWeakLambda(this, [this](FName) { CheckChargedAttack(); }));
+
 	// set the player tag
 	Tags.Add(FName("Player"));
 }
@@ -127,13 +145,15 @@ void ACombatCharacter::DoComboAttackStart()
 	// are we already playing an attack animation?
 	if (bIsAttacking)
 	{
-		// cache the input time so we can check it later
-		CachedAttackInputTime = GetWorld()->GetTimeSeconds();
+		// buffer the input so the combo notify or the end of the montage can consume it
+		InputBuffer->BufferInput(EBufferedInputType::ComboAttack);
 
 		return;
 	}
 
-	// perform a combo attack
+	// record the input and perform a combo attack
+	InputBuffer->RecordInput(EBufferedInputType::ComboAttack);
+
 	ComboAttack();
 }
 
@@ -149,12 +169,14 @@ void ACombatCharacter::DoChargedAttackStart()
 
 	if (bIsAttacking)
 	{
-		// cache the input time so we can check it later
-		CachedAttackInputTime = GetWorld()->GetTimeSeconds();
+		// buffer the input so the end of the montage can consume it
+		InputBuffer->BufferInput(EBufferedInputType::ChargedAttackPress);
 
 		return;
 	}
 
+	InputBuffer->RecordInput(EBufferedInputType::ChargedAttackPress);
+
 	ChargedAttack();
 }
 
@@ -163,6 +185,16 @@ void ACombatCharacter::DoChargedAttackEnd()
 	// lower the charging attack flag
 	bIsChargingAttack = false;
 
+	// if we're mid-attack, buffer the release so the charge loop check consumes it in order with any re-press
+	if (bIsAttacking)
+	{
+		InputBuffer->BufferInput(EBufferedInputType::ChargedAttackRelease);
+	}
+	else
+	{
+		InputBuffer->RecordInput(EBufferedInputType::ChargedAttackRelease);
+	}
+
 	// if we've done the charge loop at least once, release the charged attack right away
 	if (bHasLoopedChargedAttack)
 	{
@@ -176,7 +208,19 @@ void ACombatCharacter::ResetHP()
 	CurrentHP = MaxHP;
 
 	// update the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	SetLifeBarPercentage(1.0f);
+}
+
+void ACombatCharacter::SetLifeBarPercentage(float Percent)
+{
+	if (!bUseBatchedLifeBar)
+	{
+		LifeBarWidget->SetLifePercentage(Percent);
+	}
+	else if (UCombatLifeBarRenderer* LifeBarRenderer = GetWorld()->GetSubsystem<UCombatLifeBarRenderer>())
+	{
+		LifeBarRenderer->SetLifePercentage(this, Percent);
+	}
 }
 
 void ACombatCharacter::ComboAttack()
@@ -235,8 +279,11 @@ void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupt
 	// reset the attacking flag
 	bIsAttacking = false;
 
-	// check if we have a non-stale cached input
-	if (GetWorld()->GetTimeSeconds() - CachedAttackInputTime <= AttackInputCacheTimeTolerance)
+	// drop any charge release left over from this attack
+	InputBuffer->ClearInputs(EBufferedInputType::ChargedAttackRelease);
+
+	// check if we have a non-stale buffered attack input
+	if (InputBuffer->ConsumeInput(EBufferedInputType::ComboAttack | EBufferedInputType::ChargedAttackPress, UInputBufferComponent::SecondsToFrames(AttackInputCacheTimeTolerance)))
 	{
 		// are we holding the charged attack button?
 		if (bIsChargingAttack)
@@ -252,11 +299,30 @@ void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupt
 	}
 }
 
-void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
+void ACombatCharacter::HandleReplayedInput(EBufferedInputType Type)
 {
-	// sweep for objects in front of the character to be hit by the attack
-	TArray<FHitResult> OutHits;
+	// route the replayed input the same way as live input
+	switch (Type)
+	{
+	case EBufferedInputType::ComboAttack:
+		DoComboAttackStart();
+		break;
+
+	case EBufferedInputType::ChargedAttackPress:
+		DoChargedAttackStart();
+		break;
+
+	case EBufferedInputType::ChargedAttackRelease:
+		DoChargedAttackEnd();
+		break;
+
+	default:
+		break;
+	}
+}
 
+void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
+{
 	// start at the provided socket location, sweep forward
 	const FVector TraceStart = GetMesh()->GetSocketLocation(DamageSourceBone);
 	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * MeleeTraceDistance);
@@ -266,6 +332,16 @@ void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
 	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
 
+	// defer the trace to the batched queue if it's available. Hits come back through ResolveAttackTrace
+	if (UCombatAttackTraceQueue* TraceQueue = UCombatAttackTraceQueue::Get(GetWorld()))
+	{
+		TraceQueue->EnqueueTrace(this, TraceStart, TraceEnd, MeleeTraceRadius, ObjectParams);
+		return;
+	}
+
+	// sweep for objects in front of the character to be hit by the attack
+	TArray<FHitResult> OutHits;
+
 	// use a sphere shape for the sweep
 	FCollisionShape CollisionShape;
 	CollisionShape.SetSphere(MeleeTraceRadius);
@@ -274,25 +350,38 @@ void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
-	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
+	// use the target registry when it's available, otherwise fall back to a physics sweep
+	if (const UCombatTargetRegistry* TargetRegistry = UCombatTargetRegistry::Get(GetWorld()))
 	{
-		// iterate over each object hit
-		for (const FHitResult& CurrentHit : OutHits)
-		{
-			// check if we've hit a damageable actor
-			ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
+		TargetRegistry->SweepDamageables(TraceStart, TraceEnd, MeleeTraceRadius, ObjectParams, this, OutHits);
+	}
+	else
+	{
+		GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams);
+		CountCombatSceneQueries();
+	}
 
-			if (Damageable)
-			{
-				// knock upwards and away from the impact normal
-				const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+	ResolveAttackTrace(OutHits);
+}
 
-				// pass the damage event to the actor
-				Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+void ACombatCharacter::ResolveAttackTrace(const TArray<FHitResult>& Hits)
+{
+	// iterate over each object hit
+	for (const FHitResult& CurrentHit : Hits)
+	{
+		// check if we've hit a damageable actor
+		ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
 
-				// call the BP handler to play effects, etc.
-				DealtDamage(MeleeDamage, CurrentHit.ImpactPoint);
-			}
+		if (Damageable)
+		{
+			// knock upwards and away from the impact normal
+			const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+
+			// pass the damage event to the actor
+			Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+
+			// call the BP handler to play effects, etc.
+			DealtDamage(MeleeDamage, CurrentHit.ImpactPoint);
 		}
 	}
 }
@@ -302,12 +391,9 @@ void ACombatCharacter::CheckCombo()
 	// are we playing a non-charge attack animation?
 	if (bIsAttacking && !bIsChargingAttack)
 	{
-		// is the last attack input not stale?
-		if (GetWorld()->GetTimeSeconds() - CachedAttackInputTime <= ComboInputCacheTimeTolerance)
+		// consume the oldest non-stale attack input, so each input advances the combo once
+		if (InputBuffer->ConsumeInput(EBufferedInputType::ComboAttack | EBufferedInputType::ChargedAttackPress, UInputBufferComponent::SecondsToFrames(ComboInputCacheTimeTolerance)))
 		{
-			// consume the attack input so we don't accidentally trigger it twice
-			CachedAttackInputTime = 0.0f;
-
 			// increase the combo counter
 			++ComboCount;
 
@@ -332,15 +418,26 @@ void ACombatCharacter::CheckChargedAttack()
 	// raise the looped charged attack flag
 	bHasLoopedChargedAttack = true;
 
-	// jump to either the loop or the attack section depending on whether we're still holding the charge button
+	// consume the buffered release, so a release followed by a quick re-press still lets this charge go
+	// instead of looping on the new press. The re-press stays buffered for the end of the montage
+	const bool bReleased = InputBuffer->ConsumeInput(EBufferedInputType::ChargedAttackRelease, MAX_int32) || !bIsChargingAttack;
+
+	// jump to either the loop or the attack section depending on whether the charge was released
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
-		AnimInstance->Montage_JumpToSection(bIsChargingAttack ? ChargeLoopSection : ChargeAttackSection, ChargedAttackMontage);
+		AnimInstance->Montage_JumpToSection(bReleased ? ChargeAttackSection : ChargeLoopSection, ChargedAttackMontage);
 	}
 }
 
 void ACombatCharacter::NotifyEnemiesOfIncomingAttack()
 {
+	// publish the attack once and let the bus find the enemies it reaches
+	if (UCombatDangerEventBus* DangerBus = UCombatDangerEventBus::Get(GetWorld()))
+	{
+		DangerBus->PublishDanger(this, GetActorLocation(), GetActorForwardVector(), DangerTraceDistance, DangerTraceRadius);
+		return;
+	}
+
 	// sweep for objects in front of the character to be hit by the attack
 	TArray<FHitResult> OutHits;
 
@@ -360,6 +457,7 @@ void ACombatCharacter::NotifyEnemiesOfIncomingAttack()
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
+	CountCombatSceneQueries();
 	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
 	{
 		// iterate over each object hit
@@ -413,6 +511,11 @@ void ACombatCharacter::HandleDeath()
 	// hide the life bar
 	LifeBar->SetHiddenInGame(true);
 
+	if (UCombatLifeBarRenderer* LifeBarRenderer = GetWorld()->GetSubsystem<UCombatLifeBarRenderer>())
+	{
+		LifeBarRenderer->RemoveLifeBar(this);
+	}
+
 	// pull back the camera
 	GetCameraBoom()->TargetArmLength = DeathCameraDistance;
 
@@ -456,7 +559,7 @@ float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dama
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+		SetLifeBarPercentage(CurrentHP / MaxHP);
 
 		// enable partial ragdoll physics, but keep the pelvis vertical
 		GetMesh()->SetPhysicsBlendWeight(0.5f);
@@ -496,6 +599,16 @@ void ACombatCharacter::BeginPlay()
 	// set the life bar color
 	LifeBarWidget->SetBarColor(LifeBarColor);
 
+	// let the batched renderer draw our life bar, and stop drawing the widget
+	if (UCombatLifeBarRenderer* LifeBarRenderer = UCombatLifeBarRenderer::Get(GetWorld()))
+	{
+		bUseBatchedLifeBar = true;
+		LifeBarRenderer->AddLifeBar(this, LifeBar, LifeBarColor);
+
+		LifeBar->SetVisibility(false);
+		LifeBar->SetComponentTickEnabled(false);
+	}
+
 	// reset HP to maximum
 	ResetHP();
 }
@@ -506,6 +619,12 @@ void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the respawn timer
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// stop drawing our life bar
+	if (UCombatLifeBarRenderer* LifeBarRenderer = GetWorld()->GetSubsystem<UCombatLifeBarRenderer>())
+	{
+		LifeBarRenderer->RemoveLifeBar(this);
+	}
 }
 
 void ACombatCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -15,6 +15,9 @@ class UInputAction;
 struct FInputActionValue;
 class UCombatLifeBar;
 class UWidgetComponent;
+class UInputBufferComponent;
+class UAnimNotifyRouterComponent;
+enum class EBufferedInputType : uint8;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCombatCharacter, Log, All);
 
@@ -42,6 +45,14 @@ class ACombatCharacter : public ACharacter, public ICombatAttacker, public IComb
 	/** Life bar widget component */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UWidgetComponent* LifeBar;
+
+	/** Buffers attack inputs received mid-attack until a notify consumes them */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UInputBufferComponent* InputBuffer;
+
+	/** Routes gameplay anim notifies from the mesh without casting */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UAnimNotifyRouterComponent* NotifyRouter;
 	
 protected:
 
@@ -93,13 +104,13 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	TObjectPtr<UCombatLifeBar> LifeBarWidget;
 
+	/** If true, our life bar is drawn by the batched life bar renderer instead of the widget component */
+	bool bUseBatchedLifeBar = false;
+
 	/** Max amount of time that may elapse for a non-combo attack input to not be considered stale */
 	UPROPERTY(EditAnywhere, Category="Melee Attack", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
 	float AttackInputCacheTimeTolerance = 1.0f;
 
-	/** Time at which an attack button was last pressed */
-	float CachedAttackInputTime = 0.0f;
-
 	/** If true, the character is currently playing an attack animation */
 	bool bIsAttacking = false;
 
@@ -245,6 +256,9 @@ protected:
 	/** Resets the character's current HP to maximum */
 	void ResetHP();
 
+	/** Updates the life bar, either through the batched renderer or the widget */
+	void SetLifeBarPercentage(float Percent);
+
 	/** Performs a combo attack */
 	void ComboAttack();
 
@@ -254,6 +268,9 @@ protected:
 	/** Called from a delegate when the attack montage ends */
 	void AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
+	/** Routes inputs replayed by the input buffer to the input handlers */
+	void HandleReplayedInput(EBufferedInputType Type);
+
 	
 public:
 
@@ -268,6 +285,9 @@ public:
 	/** Performs the charged attack hold check */
 	virtual void CheckChargedAttack() override;
 
+	/** Applies damage to the targets hit by an attack trace */
+	virtual void ResolveAttackTrace(const TArray<FHitResult>& Hits) override;
+
 	// ~end CombatAttacker interface
 
 	// ~begin CombatDamageable interface
@@ -329,6 +349,9 @@ public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 
+	/** Returns InputBuffer subobject **/
+	FORCEINLINE class UInputBufferComponent* GetInputBuffer() const { return InputBuffer; }
+
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 };
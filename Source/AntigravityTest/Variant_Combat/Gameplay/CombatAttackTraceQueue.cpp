@@ -0,0 +1,261 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatAttackTraceQueue.h"
+#include "CombatSceneQueryCounter.h"
+#include "CombatAttacker.h"
+#include "CombatTargetRegistry.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Engine/OverlapResult.h"
+#include "Components/PrimitiveComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/IsSorted.h"
+
+static TAutoConsoleVariable<bool> CVarCombatAttackTraceBatching(
+	TEXT("Combat.AttackTraceQueue.Enabled"),
+	true,
+	TEXT("If true, attack traces are queued and resolved once per frame after physics instead of immediately from the anim notify."));
+
+static TAutoConsoleVariable<float> CVarCombatAttackTraceMaxBatchExtent(
+	TEXT("Combat.AttackTraceQueue.MaxBatchExtent"),
+	3000.0f,
+	TEXT("Largest half extent in cm of the shared broad-phase overlap. Frames whose traces are spread wider sweep each trace on its own."));
+
+/** Breaks ties between hits at the same distance the same way every time */
+static void SortAttackHits(TArray<FHitResult>& Hits)
+{
+	Hits.StableSort([](const FHitResult& A, const FHitResult& B)
+	{
+		if (A.Time != B.Time)
+		{
+			return A.Time < B.Time;
+		}
+
+		// actor names don't depend on object allocation, unlike unique IDs
+		const AActor* ActorA = A.GetActor();
+		const AActor* ActorB = B.GetActor();
+		return (ActorA ? ActorA->GetFName() : NAME_None).Compare(ActorB ? ActorB->GetFName() : NAME_None) < 0;
+	});
+}
+
+void FCombatAttackTraceTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Queue)
+	{
+		Queue->FlushTraces();
+	}
+}
+
+FString FCombatAttackTraceTickFunction::DiagnosticMessage()
+{
+	return TEXT("FCombatAttackTraceTickFunction");
+}
+
+UCombatAttackTraceQueue* UCombatAttackTraceQueue::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatAttackTraceBatching.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatAttackTraceQueue>();
+}
+
+void UCombatAttackTraceQueue::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// flush after physics so attacks see this frame's final positions
+	FlushTickFunction.Queue = this;
+	FlushTickFunction.bCanEverTick = true;
+	FlushTickFunction.bStartWithTickEnabled = true;
+	FlushTickFunction.TickGroup = TG_PostPhysics;
+	FlushTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UCombatAttackTraceQueue::Deinitialize()
+{
+	if (FlushTickFunction.IsTickFunctionRegistered())
+	{
+		FlushTickFunction.UnRegisterTickFunction();
+	}
+	FlushTickFunction.Queue = nullptr;
+
+	PendingRequests.Empty();
+	ResolvedHits.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatAttackTraceQueue::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatAttackTraceQueue::EnqueueTrace(AActor* Attacker, const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams)
+{
+	if (!IsValid(Attacker))
+	{
+		return;
+	}
+
+	FCombatAttackTraceRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Attacker = Attacker;
+	Request.Start = Start;
+	Request.End = End;
+	Request.Radius = Radius;
+	Request.ObjectParams = ObjectParams;
+	Request.Sequence = NextSequence++;
+}
+
+void UCombatAttackTraceQueue::FlushTraces()
+{
+	if (PendingRequests.IsEmpty())
+	{
+		return;
+	}
+
+	// take the requests, so traces queued while dispatching damage wait for the next flush
+	TArray<FCombatAttackTraceRequest> Requests = MoveTemp(PendingRequests);
+	PendingRequests.Reset();
+
+	// requests are already in queue order, which is what they resolve in. Sorting by object index would not be
+	// deterministic, since indices are recycled and depend on allocation and GC history
+	checkSlow(Algo::IsSortedBy(Requests, &FCombatAttackTraceRequest::Sequence));
+
+	// resolve every trace before any damage is applied, so all attacks this frame see the same world
+	ResolvedHits.SetNum(Requests.Num(), EAllowShrinking::No);
+
+	// the registry never queries the physics scene, otherwise share one scene query between all traces
+	if (UCombatTargetRegistry::Get(GetWorld()) || !ResolveBatchedPhysics(Requests))
+	{
+		for (int32 Index = 0; Index < Requests.Num(); ++Index)
+		{
+			ResolveRequest(Requests[Index], ResolvedHits[Index]);
+		}
+	}
+
+	// dispatch the hits in order
+	for (int32 Index = 0; Index < Requests.Num(); ++Index)
+	{
+		if (ICombatAttacker* Attacker = Cast<ICombatAttacker>(Requests[Index].Attacker.Get()))
+		{
+			Attacker->ResolveAttackTrace(ResolvedHits[Index]);
+		}
+
+		ResolvedHits[Index].Reset();
+	}
+
+	// reuse the array next frame unless something queued more while we were dispatching
+	if (PendingRequests.IsEmpty())
+	{
+		Requests.Reset();
+		PendingRequests = MoveTemp(Requests);
+	}
+}
+
+void UCombatAttackTraceQueue::ResolveRequest(const FCombatAttackTraceRequest& Request, TArray<FHitResult>& OutHits) const
+{
+	OutHits.Reset();
+
+	// skip attackers that went away since queueing
+	const AActor* Attacker = Request.Attacker.Get();
+	if (!IsValid(Attacker))
+	{
+		return;
+	}
+
+	if (const UCombatTargetRegistry* TargetRegistry = UCombatTargetRegistry::Get(GetWorld()))
+	{
+		TargetRegistry->SweepDamageables(Request.Start, Request.End, Request.Radius, Request.ObjectParams, Attacker, OutHits);
+	}
+	else
+	{
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(Attacker);
+
+		GetWorld()->SweepMultiByObjectType(OutHits, Request.Start, Request.End, FQuat::Identity, Request.ObjectParams, FCollisionShape::MakeSphere(Request.Radius), QueryParams);
+		CountCombatSceneQueries();
+	}
+
+	SortAttackHits(OutHits);
+}
+
+bool UCombatAttackTraceQueue::ResolveBatchedPhysics(const TArray<FCombatAttackTraceRequest>& Requests)
+{
+	// bound every trace of the frame, and every object type any of them looks for
+	FBox BatchBounds(ForceInit);
+	int32 BatchObjectTypes = 0;
+
+	for (const FCombatAttackTraceRequest& Request : Requests)
+	{
+		if (IsValid(Request.Attacker.Get()))
+		{
+			BatchBounds += FBox(Request.Start.ComponentMin(Request.End), Request.Start.ComponentMax(Request.End)).ExpandBy(Request.Radius);
+			BatchObjectTypes |= Request.ObjectParams.GetQueryBitfield();
+		}
+	}
+
+	// traces far apart would drag half the level into the overlap
+	if (BatchBounds.IsValid && BatchBounds.GetExtent().GetMax() > CVarCombatAttackTraceMaxBatchExtent.GetValueOnGameThread())
+	{
+		return false;
+	}
+
+	// one scene query for the whole batch
+	TArray<FOverlapResult> Overlaps;
+	if (BatchBounds.IsValid)
+	{
+		GetWorld()->OverlapMultiByObjectType(Overlaps, BatchBounds.GetCenter(), FQuat::Identity, FCollisionObjectQueryParams(BatchObjectTypes), FCollisionShape::MakeBox(BatchBounds.GetExtent()));
+		CountCombatSceneQueries();
+	}
+
+	// skeletal meshes report one overlap per body, sweep each component once
+	TArray<UPrimitiveComponent*, TInlineAllocator<32>> Components;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		if (UPrimitiveComponent* Component = Overlap.GetComponent())
+		{
+			Components.AddUnique(Component);
+		}
+	}
+
+	// narrow phase against the overlapped components only, with the same filters the per-trace sweep applies
+	for (int32 Index = 0; Index < Requests.Num(); ++Index)
+	{
+		const FCombatAttackTraceRequest& Request = Requests[Index];
+		TArray<FHitResult>& OutHits = ResolvedHits[Index];
+		OutHits.Reset();
+
+		const AActor* Attacker = Request.Attacker.Get();
+		if (!IsValid(Attacker))
+		{
+			continue;
+		}
+
+		const FCollisionShape CollisionShape = FCollisionShape::MakeSphere(Request.Radius);
+		const int32 QueryObjectTypes = Request.ObjectParams.GetQueryBitfield();
+
+		for (UPrimitiveComponent* Component : Components)
+		{
+			AActor* Owner = Component->GetOwner();
+			if (Owner == Attacker || !Component->IsQueryCollisionEnabled() || (QueryObjectTypes & ECC_TO_BITFIELD(Component->GetCollisionObjectType())) == 0)
+			{
+				continue;
+			}
+
+			FHitResult Hit;
+			if (Component->SweepComponent(Hit, Request.Start, Request.End, FQuat::Identity, CollisionShape))
+			{
+				Hit.HitObjectHandle = FActorInstanceHandle(Owner);
+				Hit.Component = Component;
+				OutHits.Add(Hit);
+			}
+		}
+
+		SortAttackHits(OutHits);
+	}
+
+	return true;
+}
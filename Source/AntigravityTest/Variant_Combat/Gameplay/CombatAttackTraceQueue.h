@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "CollisionQueryParams.h"
+#include "CombatAttackTraceQueue.generated.h"
+
+class UCombatAttackTraceQueue;
+
+/**
+ *  Tick function that resolves the queued attack traces once per frame at a fixed tick group.
+ */
+USTRUCT()
+struct FCombatAttackTraceTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Queue to flush */
+	UCombatAttackTraceQueue* Queue = nullptr;
+
+	/** Flushes the queue */
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	/** Name shown in tick diagnostics */
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCombatAttackTraceTickFunction> : public TStructOpsTypeTraitsBase2<FCombatAttackTraceTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ *  A single deferred attack trace
+ */
+struct FCombatAttackTraceRequest
+{
+	/** Actor performing the attack. Receives the hits through ICombatAttacker::ResolveAttackTrace */
+	TWeakObjectPtr<AActor> Attacker;
+
+	/** Sweep start */
+	FVector Start = FVector::ZeroVector;
+
+	/** Sweep end */
+	FVector End = FVector::ZeroVector;
+
+	/** Sweep sphere radius */
+	float Radius = 0.0f;
+
+	/** Object types the attack can hit */
+	FCollisionObjectQueryParams ObjectParams;
+
+	/** Order this request was queued in. Requests resolve in this order */
+	uint32 Sequence = 0;
+};
+
+/**
+ *  World subsystem that batches attack traces.
+ *  Attack notifies queue their traces instead of sweeping right away. Once per frame, after physics,
+ *  all queued traces are resolved in one pass and their damage is dispatched in a deterministic order.
+ *  Without the target registry, the pass runs a single broad-phase overlap around every trace of the frame,
+ *  so the physics scene is queried once, and each trace then sweeps only the components that overlap returned.
+ */
+UCLASS()
+class UCombatAttackTraceQueue : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Returns the queue for the given world, or nullptr if batching is disabled */
+	static UCombatAttackTraceQueue* Get(const UWorld* World);
+
+	/** Registers the flush tick function */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Unregisters the flush tick function and drops pending traces */
+	virtual void Deinitialize() override;
+
+	/** Only create the queue for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Queues a sphere sweep for the attacker. Hits are delivered through ICombatAttacker::ResolveAttackTrace when the queue flushes */
+	void EnqueueTrace(AActor* Attacker, const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams);
+
+	/** Resolves all queued traces, then dispatches their hits */
+	void FlushTraces();
+
+	/** Returns the number of traces waiting for the next flush */
+	int32 GetNumPendingTraces() const { return PendingRequests.Num(); }
+
+protected:
+
+	/** Runs a single trace against the target registry, or the physics scene if the registry is disabled */
+	void ResolveRequest(const FCombatAttackTraceRequest& Request, TArray<FHitResult>& OutHits) const;
+
+	/**
+	 *  Resolves all requests against the physics scene with one overlap for the whole batch, then sweeps each
+	 *  request against the overlapped components only. Returns false without resolving anything if the batch is
+	 *  spread too far apart for a shared overlap to pay off.
+	 */
+	bool ResolveBatchedPhysics(const TArray<FCombatAttackTraceRequest>& Requests);
+
+	/** Traces waiting for the next flush */
+	TArray<FCombatAttackTraceRequest> PendingRequests;
+
+	/** Hits for each request of the flush in progress, kept around to reuse the allocations */
+	TArray<TArray<FHitResult>> ResolvedHits;
+
+	/** Counter used to stamp requests in the order they were queued */
+	uint32 NextSequence = 0;
+
+	/** Tick function that flushes the queue */
+	FCombatAttackTraceTickFunction FlushTickFunction;
+};
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDangerEventBus.h"
+#include "CombatDamageable.h"
+#include "CombatTargetRegistry.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_Combat_Event_Danger, "Combat.Event.Danger", "Sent to a combat enemy's StateTree when an incoming attack is about to reach it");
+
+static TAutoConsoleVariable<bool> CVarCombatDangerEventBusEnabled(
+	TEXT("Combat.DangerEventBus.Enabled"),
+	true,
+	TEXT("If true, incoming attacks are published through the danger event bus instead of sweeping for enemies to notify."));
+
+UCombatDangerEventBus* UCombatDangerEventBus::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatDangerEventBusEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatDangerEventBus>();
+}
+
+void UCombatDangerEventBus::Deinitialize()
+{
+	Listeners.Empty();
+	ListenerSet.Empty();
+	OnDangerPublished.Clear();
+
+	Super::Deinitialize();
+}
+
+bool UCombatDangerEventBus::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatDangerEventBus::RegisterListener(AActor* Listener)
+{
+	// only damageables can receive danger notifications
+	if (!IsValid(Listener) || !Listener->Implements<UCombatDamageable>() || ListenerSet.Contains(Listener))
+	{
+		return;
+	}
+
+	Listeners.Add(Listener);
+	ListenerSet.Add(Listener);
+}
+
+void UCombatDangerEventBus::UnregisterListener(AActor* Listener)
+{
+	if (ListenerSet.Remove(Listener) > 0)
+	{
+		Listeners.Remove(Listener);
+	}
+}
+
+void UCombatDangerEventBus::PublishDanger(AActor* Source, const FVector& Origin, const FVector& Direction, float Length, float Radius)
+{
+	FCombatDangerEvent Event;
+	Event.Source = Source;
+	Event.Origin = Origin;
+	Event.Direction = Direction.GetSafeNormal();
+	Event.Length = Length;
+	Event.Radius = Radius;
+	Event.Time = GetWorld()->GetTimeSeconds();
+
+	OnDangerPublished.Broadcast(Event);
+
+	// nobody to notify
+	if (ListenerSet.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<AActor*> Reached;
+	GatherListeners(Event, Reached);
+
+	for (AActor* Listener : Reached)
+	{
+		if (ICombatDamageable* Damageable = Cast<ICombatDamageable>(Listener))
+		{
+			Damageable->NotifyDanger(Origin, Source);
+		}
+	}
+}
+
+void UCombatDangerEventBus::GatherListeners(const FCombatDangerEvent& Event, TArray<AActor*>& OutListeners) const
+{
+	const FVector End = Event.Origin + Event.Direction * Event.Length;
+
+	// use the spatial hash when available and keep only the actors that subscribed
+	if (const UCombatTargetRegistry* TargetRegistry = UCombatTargetRegistry::Get(GetWorld()))
+	{
+		FCollisionObjectQueryParams ObjectParams;
+		ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+
+		TargetRegistry->QuerySweptSphere(Event.Origin, End, Event.Radius, ObjectParams, Event.Source, OutListeners);
+
+		OutListeners.RemoveAllSwap([this](const AActor* Candidate)
+		{
+			return !ListenerSet.Contains(Candidate);
+		}, EAllowShrinking::No);
+
+		return;
+	}
+
+	// otherwise test each listener's bounds against the swept sphere
+	for (const TWeakObjectPtr<AActor>& WeakListener : Listeners)
+	{
+		AActor* Listener = WeakListener.Get();
+		if (!Listener || Listener == Event.Source || !Listener->GetRootComponent())
+		{
+			continue;
+		}
+
+		const FBoxSphereBounds& Bounds = Listener->GetRootComponent()->Bounds;
+		const float Reach = Event.Radius + Bounds.SphereRadius;
+
+		if (FMath::PointDistToSegmentSquared(Bounds.Origin, Event.Origin, End) <= FMath::Square(Reach))
+		{
+			OutListeners.Add(Listener);
+		}
+	}
+}
@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NativeGameplayTags.h"
+#include "CombatDangerEventBus.generated.h"
+
+/** StateTree event sent to a listener when it is caught inside a danger volume */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Combat_Event_Danger);
+
+/**
+ *  Describes an incoming attack: a sphere of the given radius swept forward from the origin
+ */
+USTRUCT(BlueprintType)
+struct FCombatDangerEvent
+{
+	GENERATED_BODY()
+
+	/** Actor performing the attack */
+	UPROPERTY(BlueprintReadOnly, Category="Danger")
+	TObjectPtr<AActor> Source;
+
+	/** Start of the danger volume */
+	UPROPERTY(BlueprintReadOnly, Category="Danger")
+	FVector Origin = FVector::ZeroVector;
+
+	/** Normalized direction the attack travels in */
+	UPROPERTY(BlueprintReadOnly, Category="Danger")
+	FVector Direction = FVector::ForwardVector;
+
+	/** Length of the danger volume */
+	UPROPERTY(BlueprintReadOnly, Category="Danger")
+	float Length = 0.0f;
+
+	/** Radius of the danger volume */
+	UPROPERTY(BlueprintReadOnly, Category="Danger")
+	float Radius = 0.0f;
+
+	/** Game time the event was published at */
+	UPROPERTY(BlueprintReadOnly, Category="Danger")
+	float Time = 0.0f;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCombatDangerPublished, const FCombatDangerEvent&);
+
+/**
+ *  World subsystem that publishes incoming attacks to the actors that listen for them.
+ *  Each attack is published once. Listeners inside the danger volume are found through the
+ *  combat target registry and notified through ICombatDamageable::NotifyDanger.
+ */
+UCLASS()
+class UCombatDangerEventBus : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Returns the bus for the given world, or nullptr if the bus is disabled */
+	static UCombatDangerEventBus* Get(const UWorld* World);
+
+	/** Drops all listeners */
+	virtual void Deinitialize() override;
+
+	/** Only create the bus for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Subscribes a damageable actor to danger events that reach it */
+	void RegisterListener(AActor* Listener);
+
+	/** Unsubscribes an actor from danger events */
+	void UnregisterListener(AActor* Listener);
+
+	/** Publishes an incoming attack and notifies every listener inside the swept sphere */
+	void PublishDanger(AActor* Source, const FVector& Origin, const FVector& Direction, float Length, float Radius);
+
+	/** Returns the number of subscribed listeners */
+	int32 GetNumListeners() const { return Listeners.Num(); }
+
+	/** Broadcast once for every published event, before listeners are notified */
+	FOnCombatDangerPublished OnDangerPublished;
+
+protected:
+
+	/** Gathers the listeners inside the danger volume */
+	void GatherListeners(const FCombatDangerEvent& Event, TArray<AActor*>& OutListeners) const;
+
+	/** Subscribed listeners, in registration order */
+	TArray<TWeakObjectPtr<AActor>> Listeners;
+
+	/** Subscribed listeners, for fast membership tests on spatial query results */
+	TSet<const AActor*> ListenerSet;
+};
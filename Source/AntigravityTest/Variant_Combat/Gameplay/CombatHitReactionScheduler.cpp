@@ -0,0 +1,186 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatHitReactionScheduler.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarCombatHitReactionsEnabled(
+	TEXT("Combat.HitReactions.Enabled"),
+	true,
+	TEXT("If true, partial ragdoll hit reactions are scheduled and kept warm by the hit reaction scheduler."));
+
+static TAutoConsoleVariable<float> CVarCombatHitReactionsMergeWindow(
+	TEXT("Combat.HitReactions.MergeWindow"),
+	0.15f,
+	TEXT("Seconds after a hit reaction starts during which further hits are merged into it."));
+
+static TAutoConsoleVariable<float> CVarCombatHitReactionsHoldTime(
+	TEXT("Combat.HitReactions.HoldTime"),
+	0.2f,
+	TEXT("Seconds a hit reaction holds its peak physics blend weight."));
+
+static TAutoConsoleVariable<float> CVarCombatHitReactionsBlendOutTime(
+	TEXT("Combat.HitReactions.BlendOutTime"),
+	0.3f,
+	TEXT("Seconds a hit reaction takes to blend back to animation after the hold."));
+
+static TAutoConsoleVariable<float> CVarCombatHitReactionsWarmTime(
+	TEXT("Combat.HitReactions.WarmTime"),
+	1.5f,
+	TEXT("Seconds the reaction bodies keep simulating after blending out, so the next hit doesn't toggle simulation."));
+
+static TAutoConsoleVariable<int32> CVarCombatHitReactionsMaxWarm(
+	TEXT("Combat.HitReactions.MaxWarm"),
+	16,
+	TEXT("Maximum number of meshes with warm hit reaction bodies. The least recently hit one cools down first."));
+
+UCombatHitReactionScheduler* UCombatHitReactionScheduler::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatHitReactionsEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatHitReactionScheduler>();
+}
+
+bool UCombatHitReactionScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatHitReactionScheduler::Deinitialize()
+{
+	Reactions.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatHitReactionScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatHitReactionScheduler, STATGROUP_Tickables);
+}
+
+void UCombatHitReactionScheduler::AddHitReaction(USkeletalMeshComponent* Mesh, FName RootBone, float BlendWeight)
+{
+	if (!IsValid(Mesh))
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// is this mesh still warm from an earlier hit?
+	const int32 ReactionIndex = Reactions.IndexOfByPredicate([Mesh](const FHitReaction& Reaction)
+	{
+		return Reaction.Mesh.Get() == Mesh;
+	});
+
+	if (ReactionIndex != INDEX_NONE)
+	{
+		// fold hits that land right after the previous one into the same reaction
+		if (Now - Reactions[ReactionIndex].StartTime < CVarCombatHitReactionsMergeWindow.GetValueOnGameThread())
+		{
+			return;
+		}
+
+		// restart the ramp without touching body simulation, and move to the most recently hit end
+		FHitReaction Reaction = Reactions[ReactionIndex];
+		Reaction.PeakBlendWeight = BlendWeight;
+		Reaction.StartTime = Now;
+
+		Reactions.RemoveAt(ReactionIndex, 1, EAllowShrinking::No);
+		Reactions.Add(Reaction);
+		return;
+	}
+
+	// make room by cooling the least recently hit mesh
+	const int32 MaxWarm = FMath::Max(1, CVarCombatHitReactionsMaxWarm.GetValueOnGameThread());
+	while (Reactions.Num() >= MaxWarm)
+	{
+		CoolReactionAt(0);
+	}
+
+	// warm up the bodies once. The root stays kinematic so the character stays upright
+	Mesh->SetAllBodiesBelowSimulatePhysics(RootBone, true, false);
+
+	FHitReaction& NewReaction = Reactions.AddDefaulted_GetRef();
+	NewReaction.Mesh = Mesh;
+	NewReaction.RootBone = RootBone;
+	NewReaction.PeakBlendWeight = BlendWeight;
+	NewReaction.StartTime = Now;
+
+	// apply the peak right away so the hit frame already reacts. Weights are set per body, the component-wide
+	// SetPhysicsBlendWeight would toggle simulation on every body, the root included
+	Mesh->SetAllBodiesBelowPhysicsBlendWeight(RootBone, BlendWeight, false, false);
+	NewReaction.AppliedBlendWeight = BlendWeight;
+}
+
+void UCombatHitReactionScheduler::CancelHitReaction(USkeletalMeshComponent* Mesh)
+{
+	Reactions.RemoveAll([Mesh](const FHitReaction& Reaction)
+	{
+		return Reaction.Mesh.Get() == Mesh;
+	});
+}
+
+void UCombatHitReactionScheduler::CoolReactionAt(int32 ReactionIndex)
+{
+	const FHitReaction& Reaction = Reactions[ReactionIndex];
+
+	if (USkeletalMeshComponent* Mesh = Reaction.Mesh.Get())
+	{
+		Mesh->SetAllBodiesBelowPhysicsBlendWeight(Reaction.RootBone, 0.0f, false, false);
+		Mesh->SetAllBodiesBelowSimulatePhysics(Reaction.RootBone, false, false);
+	}
+
+	// keep the array ordered by hit time
+	Reactions.RemoveAt(ReactionIndex, 1, EAllowShrinking::No);
+}
+
+void UCombatHitReactionScheduler::Tick(float DeltaTime)
+{
+	if (Reactions.IsEmpty())
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float HoldTime = CVarCombatHitReactionsHoldTime.GetValueOnGameThread();
+	const float BlendOutTime = CVarCombatHitReactionsBlendOutTime.GetValueOnGameThread();
+	const float WarmTime = CVarCombatHitReactionsWarmTime.GetValueOnGameThread();
+
+	for (int32 ReactionIndex = Reactions.Num() - 1; ReactionIndex >= 0; --ReactionIndex)
+	{
+		FHitReaction& Reaction = Reactions[ReactionIndex];
+		USkeletalMeshComponent* Mesh = Reaction.Mesh.Get();
+
+		if (!Mesh)
+		{
+			Reactions.RemoveAt(ReactionIndex, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		const float Elapsed = float(Now - Reaction.StartTime);
+
+		// cool down bodies that have been idle long enough
+		if (Elapsed >= HoldTime + BlendOutTime + WarmTime)
+		{
+			CoolReactionAt(ReactionIndex);
+			continue;
+		}
+
+		// hold the peak, then ramp down to full animation
+		const float BlendAlpha = BlendOutTime > 0.0f ? FMath::Clamp((Elapsed - HoldTime) / BlendOutTime, 0.0f, 1.0f) : float(Elapsed >= HoldTime);
+		const float BlendWeight = FMath::Lerp(Reaction.PeakBlendWeight, 0.0f, BlendAlpha);
+
+		// only push the weight when it changed. Warm meshes sitting at zero cost nothing here, and keep simulating
+		if (BlendWeight != Reaction.AppliedBlendWeight)
+		{
+			Mesh->SetAllBodiesBelowPhysicsBlendWeight(Reaction.RootBone, BlendWeight, false, false);
+			Reaction.AppliedBlendWeight = BlendWeight;
+		}
+	}
+}
@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatHitReactionScheduler.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ *  World subsystem that drives partial ragdoll hit reactions for all characters in one batched pass.
+ *  The bodies below the reaction root are switched to simulation once and kept warm for a while after the
+ *  reaction fades, so repeated hits don't toggle body simulation on the physics thread every time.
+ *  Blend weights are ramped per body, only cooling a reaction turns simulation off.
+ *  Hits that land within the merge window of the previous one are folded into the same reaction.
+ */
+UCLASS()
+class UCombatHitReactionScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A mesh with warm hit reaction bodies */
+	struct FHitReaction
+	{
+		/** Reacting mesh */
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+		/** Bone the simulated bodies hang from. It stays kinematic */
+		FName RootBone;
+
+		/** Physics blend weight at the start of the reaction */
+		float PeakBlendWeight = 0.0f;
+
+		/** Physics blend weight applied last */
+		float AppliedBlendWeight = 0.0f;
+
+		/** Game time the current reaction started */
+		double StartTime = 0.0;
+	};
+
+public:
+
+	/** Returns the scheduler for the given world, or nullptr if it is disabled */
+	static UCombatHitReactionScheduler* Get(const UWorld* World);
+
+	/** Only create the scheduler for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Drops all reactions */
+	virtual void Deinitialize() override;
+
+	/** Updates every reaction's blend weight and cools down the ones that expired */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Starts a hit reaction on the mesh, or folds the hit into the reaction that is already playing */
+	void AddHitReaction(USkeletalMeshComponent* Mesh, FName RootBone, float BlendWeight);
+
+	/** Stops tracking the mesh without touching its bodies, e.g. because it's about to ragdoll */
+	void CancelHitReaction(USkeletalMeshComponent* Mesh);
+
+	/** Returns the number of meshes with warm hit reaction bodies */
+	int32 GetNumWarmReactions() const { return Reactions.Num(); }
+
+protected:
+
+	/** Turns simulation off for the reaction at the given index and stops tracking it */
+	void CoolReactionAt(int32 ReactionIndex);
+
+	/** Meshes with warm bodies, least recently hit first */
+	TArray<FHitReaction> Reactions;
+};
@@ -0,0 +1,213 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatRagdollBudget.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Stats/Stats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Ragdolls"), STAT_CombatActiveRagdolls, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Ragdoll Simulating Bodies"), STAT_CombatRagdollBodies, STATGROUP_Game);
+
+static TAutoConsoleVariable<bool> CVarCombatRagdollBudgetEnabled(
+	TEXT("Combat.RagdollBudget.Enabled"),
+	true,
+	TEXT("If true, death ragdolls are limited by the ragdoll budget. If false, every death simulates a full ragdoll."));
+
+static TAutoConsoleVariable<int32> CVarCombatRagdollBudgetMaxActive(
+	TEXT("Combat.RagdollBudget.MaxActive"),
+	8,
+	TEXT("Maximum number of death ragdolls simulating at the same time. The oldest one goes to sleep when a new one starts."));
+
+static TAutoConsoleVariable<float> CVarCombatRagdollBudgetSleepSpeed(
+	TEXT("Combat.RagdollBudget.SleepSpeed"),
+	15.0f,
+	TEXT("Speed in cm/s under which a ragdoll is considered settled."));
+
+static TAutoConsoleVariable<float> CVarCombatRagdollBudgetSettleTime(
+	TEXT("Combat.RagdollBudget.SettleTime"),
+	0.5f,
+	TEXT("Seconds a ragdoll must stay settled before it's put to sleep."));
+
+static TAutoConsoleVariable<float> CVarCombatRagdollBudgetOffscreenTolerance(
+	TEXT("Combat.RagdollBudget.OffscreenTolerance"),
+	0.2f,
+	TEXT("Seconds a mesh can go unrendered before its death is considered off-screen and skips the ragdoll."));
+
+UCombatRagdollBudget* UCombatRagdollBudget::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatRagdollBudgetEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatRagdollBudget>();
+}
+
+bool UCombatRagdollBudget::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatRagdollBudget::Deinitialize()
+{
+	ActiveRagdolls.Empty();
+	NumSimulatingBodies = 0;
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatRagdollBudget::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatRagdollBudget, STATGROUP_Tickables);
+}
+
+bool UCombatRagdollBudget::TryStartRagdoll(USkeletalMeshComponent* Mesh, FSimpleDelegate OnEvicted)
+{
+	if (!IsValid(Mesh))
+	{
+		return false;
+	}
+
+	const int32 MaxActive = CVarCombatRagdollBudgetMaxActive.GetValueOnGameThread();
+
+	// nobody would see an off-screen ragdoll
+	if (MaxActive <= 0 || !Mesh->WasRecentlyRendered(CVarCombatRagdollBudgetOffscreenTolerance.GetValueOnGameThread()))
+	{
+		return false;
+	}
+
+	// the newest death is the one the player is looking at, so make room by evicting an older ragdoll
+	while (ActiveRagdolls.Num() >= MaxActive)
+	{
+		EvictRagdollAt(FindRagdollToEvict());
+	}
+
+	Mesh->SetSimulatePhysics(true);
+
+	FActiveRagdoll& NewRagdoll = ActiveRagdolls.AddDefaulted_GetRef();
+	NewRagdoll.Mesh = Mesh;
+	NewRagdoll.OnEvicted = MoveTemp(OnEvicted);
+
+	return true;
+}
+
+void UCombatRagdollBudget::ReleaseRagdoll(USkeletalMeshComponent* Mesh)
+{
+	ActiveRagdolls.RemoveAll([Mesh](const FActiveRagdoll& Ragdoll)
+	{
+		return Ragdoll.Mesh.Get() == Mesh;
+	});
+}
+
+void UCombatRagdollBudget::SleepRagdollAt(int32 RagdollIndex)
+{
+	if (USkeletalMeshComponent* Mesh = ActiveRagdolls[RagdollIndex].Mesh.Get())
+	{
+		Mesh->PutAllRigidBodiesToSleep();
+	}
+
+	// keep the array ordered by age
+	ActiveRagdolls.RemoveAt(RagdollIndex, 1, EAllowShrinking::No);
+}
+
+int32 UCombatRagdollBudget::FindRagdollToEvict() const
+{
+	int32 SlowestIndex = INDEX_NONE;
+	float SlowestSpeedSquared = UE_MAX_FLT;
+
+	// the array is ordered by age, so the first settled ragdoll is the oldest one
+	for (int32 RagdollIndex = 0; RagdollIndex < ActiveRagdolls.Num(); ++RagdollIndex)
+	{
+		const FActiveRagdoll& Ragdoll = ActiveRagdolls[RagdollIndex];
+		const USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get();
+
+		if (!Mesh || Ragdoll.SettledTime > 0.0f)
+		{
+			return RagdollIndex;
+		}
+
+		const float SpeedSquared = Mesh->GetPhysicsLinearVelocity().SizeSquared();
+		if (SpeedSquared < SlowestSpeedSquared)
+		{
+			SlowestSpeedSquared = SpeedSquared;
+			SlowestIndex = RagdollIndex;
+		}
+	}
+
+	return SlowestIndex;
+}
+
+void UCombatRagdollBudget::EvictRagdollAt(int32 RagdollIndex)
+{
+	const FActiveRagdoll& Ragdoll = ActiveRagdolls[RagdollIndex];
+	USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get();
+
+	// a ragdoll that's still falling or flying would freeze mid-air if put to sleep
+	const float SleepSpeed = CVarCombatRagdollBudgetSleepSpeed.GetValueOnGameThread();
+	const bool bMoving = Mesh && Mesh->GetPhysicsLinearVelocity().SizeSquared() >= FMath::Square(SleepSpeed);
+
+	if (!bMoving || !Ragdoll.OnEvicted.IsBound())
+	{
+		SleepRagdollAt(RagdollIndex);
+		return;
+	}
+
+	// stop tracking it before handing it back, the owner may start a new death right away
+	const FSimpleDelegate OnEvicted = Ragdoll.OnEvicted;
+	ActiveRagdolls.RemoveAt(RagdollIndex, 1, EAllowShrinking::No);
+
+	Mesh->SetSimulatePhysics(false);
+	OnEvicted.ExecuteIfBound();
+}
+
+void UCombatRagdollBudget::Tick(float DeltaTime)
+{
+	const float SleepSpeedSquared = FMath::Square(CVarCombatRagdollBudgetSleepSpeed.GetValueOnGameThread());
+	const float SettleTime = CVarCombatRagdollBudgetSettleTime.GetValueOnGameThread();
+
+	NumSimulatingBodies = 0;
+
+	for (int32 RagdollIndex = ActiveRagdolls.Num() - 1; RagdollIndex >= 0; --RagdollIndex)
+	{
+		FActiveRagdoll& Ragdoll = ActiveRagdolls[RagdollIndex];
+		USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get();
+
+		// drop ragdolls that were removed or stopped simulating on their own
+		if (!Mesh || !Mesh->IsSimulatingPhysics())
+		{
+			ActiveRagdolls.RemoveAt(RagdollIndex, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		// has the ragdoll stopped moving?
+		if (Mesh->GetPhysicsLinearVelocity().SizeSquared() < SleepSpeedSquared)
+		{
+			Ragdoll.SettledTime += DeltaTime;
+
+			if (Ragdoll.SettledTime >= SettleTime)
+			{
+				SleepRagdollAt(RagdollIndex);
+				continue;
+			}
+		}
+		else
+		{
+			Ragdoll.SettledTime = 0.0f;
+		}
+
+		// count the bodies that are still costing us simulation time
+		for (const FBodyInstance* Body : Mesh->Bodies)
+		{
+			if (Body && Body->IsInstanceSimulatingPhysics() && Body->IsInstanceAwake())
+			{
+				++NumSimulatingBodies;
+			}
+		}
+	}
+
+	SET_DWORD_STAT(STAT_CombatActiveRagdolls, ActiveRagdolls.Num());
+	SET_DWORD_STAT(STAT_CombatRagdollBodies, NumSimulatingBodies);
+}
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatRagdollBudget.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ *  World subsystem that limits how many death ragdolls simulate at the same time.
+ *  New ragdolls evict the oldest settled one, or the slowest one, when the budget is full, and ragdolls are put to
+ *  sleep as soon as they settle instead of simulating for the whole death removal time.
+ *  A ragdoll evicted while still flying is handed back to its owner instead of freezing mid-air.
+ *  Off-screen deaths don't get a ragdoll at all, so the caller can fall back to a cheaper death.
+ */
+UCLASS()
+class UCombatRagdollBudget : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A ragdoll that is currently simulating */
+	struct FActiveRagdoll
+	{
+		/** Simulating mesh */
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+		/** Seconds the ragdoll has been moving slower than the sleep speed */
+		float SettledTime = 0.0f;
+
+		/** Called if the ragdoll is evicted while it's still moving */
+		FSimpleDelegate OnEvicted;
+	};
+
+public:
+
+	/** Returns the ragdoll budget for the given world, or nullptr if it is disabled */
+	static UCombatRagdollBudget* Get(const UWorld* World);
+
+	/** Only create the budget for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Drops all tracked ragdolls */
+	virtual void Deinitialize() override;
+
+	/** Puts settled ragdolls to sleep and updates the body count */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 *  Starts full ragdoll physics on the mesh if the budget allows it, evicting another ragdoll if needed.
+	 *  OnEvicted runs if this ragdoll is later evicted while still moving. Simulation is already off by then, so the
+	 *  owner should switch to its fallback death. Unbound, a moving evicted ragdoll is put to sleep where it is.
+	 *  Returns false if the mesh is off-screen or no ragdolls are allowed, in which case nothing is simulated.
+	 */
+	bool TryStartRagdoll(USkeletalMeshComponent* Mesh, FSimpleDelegate OnEvicted = FSimpleDelegate());
+
+	/** Stops tracking a ragdoll, e.g. because its owner is being removed */
+	void ReleaseRagdoll(USkeletalMeshComponent* Mesh);
+
+	/** Returns the number of ragdolls currently counted against the budget */
+	int32 GetNumActiveRagdolls() const { return ActiveRagdolls.Num(); }
+
+	/** Returns the number of awake, simulating bodies across all tracked ragdolls, as of the last tick */
+	int32 GetNumSimulatingBodies() const { return NumSimulatingBodies; }
+
+protected:
+
+	/** Puts the ragdoll at the given index to sleep and stops tracking it */
+	void SleepRagdollAt(int32 RagdollIndex);
+
+	/** Returns the ragdoll to evict first: the oldest settled one, otherwise the slowest one */
+	int32 FindRagdollToEvict() const;
+
+	/** Stops tracking the ragdoll at the given index, putting it to sleep if it has settled or handing it back to its owner otherwise */
+	void EvictRagdollAt(int32 RagdollIndex);
+
+	/** Ragdolls counted against the budget, oldest first */
+	TArray<FActiveRagdoll> ActiveRagdolls;
+
+	/** Awake, simulating bodies across all tracked ragdolls */
+	int32 NumSimulatingBodies = 0;
+};
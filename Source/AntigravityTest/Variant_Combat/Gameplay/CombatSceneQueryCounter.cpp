@@ -0,0 +1,6 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatSceneQueryCounter.h"
+
+uint64 GCombatSceneQueryCount = 0;
@@ -0,0 +1,14 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Running count of the scene queries issued by combat code on the game thread. Sampled per frame by the combat benchmark */
+extern uint64 GCombatSceneQueryCount;
+
+/** Counts scene queries issued by combat code */
+FORCEINLINE void CountCombatSceneQueries(int32 NumQueries = 1)
+{
+	GCombatSceneQueryCount += NumQueries;
+}
@@ -0,0 +1,427 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatTargetRegistry.h"
+#include "CombatSceneQueryCounter.h"
+#include "CombatDamageable.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+
+static TAutoConsoleVariable<bool> CVarCombatTargetRegistryEnabled(
+	TEXT("Combat.TargetRegistry.Enabled"),
+	true,
+	TEXT("If true, melee and danger traces query the combat target registry instead of sweeping the physics scene."));
+
+static TAutoConsoleVariable<float> CVarCombatTargetRegistryCellSize(
+	TEXT("Combat.TargetRegistry.CellSize"),
+	400.0f,
+	TEXT("Edge length in cm of a combat target registry hash cell. Read when the world starts."));
+
+UCombatTargetRegistry* UCombatTargetRegistry::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatTargetRegistryEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatTargetRegistry>();
+}
+
+void UCombatTargetRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CellSize = FMath::Max(50.0f, CVarCombatTargetRegistryCellSize.GetValueOnGameThread());
+
+	// pick up damageables as they are spawned
+	ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UCombatTargetRegistry::OnActorSpawned));
+}
+
+void UCombatTargetRegistry::Deinitialize()
+{
+	GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+
+	// stop watching everything that is still registered
+	for (const TWeakObjectPtr<AActor>& WeakActor : EntryActors)
+	{
+		if (AActor* Actor = WeakActor.Get())
+		{
+			if (USceneComponent* Root = Actor->GetRootComponent())
+			{
+				Root->TransformUpdated.RemoveAll(this);
+			}
+			Actor->OnEndPlay.RemoveDynamic(this, &UCombatTargetRegistry::OnTargetEndPlay);
+		}
+	}
+
+	EntryActors.Empty();
+	EntryCenters.Empty();
+	EntryRadii.Empty();
+	EntryCells.Empty();
+	Cells.Empty();
+	ActorToEntry.Empty();
+	ComponentToEntry.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCombatTargetRegistry::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// register the damageables placed in the level
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		RegisterTarget(*It);
+	}
+}
+
+bool UCombatTargetRegistry::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatTargetRegistry::RegisterTarget(AActor* Actor)
+{
+	// only damageables with a root component are tracked
+	if (!IsValid(Actor) || !Actor->Implements<UCombatDamageable>() || !Actor->GetRootComponent() || ActorToEntry.Contains(Actor))
+	{
+		return;
+	}
+
+	USceneComponent* Root = Actor->GetRootComponent();
+
+	const int32 EntryIndex = EntryActors.Add(Actor);
+	EntryCenters.Add(FVector::ZeroVector);
+	EntryRadii.Add(0.0f);
+	EntryCells.Add(FIntVector(MAX_int32));
+
+	ActorToEntry.Add(Actor, EntryIndex);
+	ComponentToEntry.Add(Root, EntryIndex);
+
+	// place it in the hash
+	UpdateEntry(EntryIndex);
+
+	// follow the actor as it moves and forget it when it leaves play
+	Root->TransformUpdated.AddUObject(this, &UCombatTargetRegistry::OnTargetMoved);
+	Actor->OnEndPlay.AddUniqueDynamic(this, &UCombatTargetRegistry::OnTargetEndPlay);
+}
+
+void UCombatTargetRegistry::UnregisterTarget(AActor* Actor)
+{
+	const int32* FoundIndex = ActorToEntry.Find(Actor);
+	if (!FoundIndex)
+	{
+		return;
+	}
+
+	const int32 EntryIndex = *FoundIndex;
+	const int32 LastIndex = EntryActors.Num() - 1;
+
+	// stop listening
+	if (USceneComponent* Root = Actor->GetRootComponent())
+	{
+		Root->TransformUpdated.RemoveAll(this);
+		ComponentToEntry.Remove(Root);
+	}
+	Actor->OnEndPlay.RemoveDynamic(this, &UCombatTargetRegistry::OnTargetEndPlay);
+	ActorToEntry.Remove(Actor);
+
+	// remove the entry from its cell
+	if (TArray<int32>* Cell = Cells.Find(EntryCells[EntryIndex]))
+	{
+		Cell->RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+		if (Cell->IsEmpty())
+		{
+			Cells.Remove(EntryCells[EntryIndex]);
+		}
+	}
+
+	// the last entry moves into the freed slot, so every reference to it has to follow
+	if (EntryIndex != LastIndex)
+	{
+		if (TArray<int32>* MovedCell = Cells.Find(EntryCells[LastIndex]))
+		{
+			const int32 CellSlot = MovedCell->Find(LastIndex);
+			if (CellSlot != INDEX_NONE)
+			{
+				(*MovedCell)[CellSlot] = EntryIndex;
+			}
+		}
+
+		if (AActor* MovedActor = EntryActors[LastIndex].Get())
+		{
+			ActorToEntry.Add(MovedActor, EntryIndex);
+			ComponentToEntry.Add(MovedActor->GetRootComponent(), EntryIndex);
+		}
+	}
+
+	EntryActors.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+	EntryCenters.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+	EntryRadii.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+	EntryCells.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+}
+
+void UCombatTargetRegistry::OnActorSpawned(AActor* Actor)
+{
+	RegisterTarget(Actor);
+}
+
+void UCombatTargetRegistry::OnTargetEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterTarget(Actor);
+}
+
+void UCombatTargetRegistry::OnTargetMoved(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (const int32* EntryIndex = ComponentToEntry.Find(Component))
+	{
+		UpdateEntry(*EntryIndex);
+	}
+}
+
+void UCombatTargetRegistry::UpdateEntry(int32 EntryIndex)
+{
+	const AActor* Actor = EntryActors[EntryIndex].Get();
+	const USceneComponent* Root = Actor ? Actor->GetRootComponent() : nullptr;
+	if (!Root)
+	{
+		return;
+	}
+
+	// the root component's cached bounds are already up to date after a move
+	EntryCenters[EntryIndex] = Root->Bounds.Origin;
+	EntryRadii[EntryIndex] = Root->Bounds.SphereRadius;
+	MaxTargetRadius = FMath::Max(MaxTargetRadius, Root->Bounds.SphereRadius);
+
+	// move to a new cell only when the center crosses a cell boundary
+	const FIntVector NewCell = GetCell(EntryCenters[EntryIndex]);
+	const FIntVector OldCell = EntryCells[EntryIndex];
+	if (NewCell == OldCell)
+	{
+		return;
+	}
+
+	if (TArray<int32>* Cell = Cells.Find(OldCell))
+	{
+		Cell->RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+		if (Cell->IsEmpty())
+		{
+			Cells.Remove(OldCell);
+		}
+	}
+
+	Cells.FindOrAdd(NewCell).Add(EntryIndex);
+	EntryCells[EntryIndex] = NewCell;
+}
+
+FIntVector UCombatTargetRegistry::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+void UCombatTargetRegistry::QuerySphere(const FVector& Center, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<AActor*>& OutActors) const
+{
+	QuerySweptSphere(Center, Center, Radius, ObjectParams, IgnoredActor, OutActors);
+}
+
+void UCombatTargetRegistry::QuerySweptSphere(const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<AActor*>& OutActors) const
+{
+	TArray<int32> Entries;
+	QuerySegment(Start, End, Radius, ObjectParams, IgnoredActor, Entries);
+
+	OutActors.Reset();
+	for (const int32 EntryIndex : Entries)
+	{
+		if (AActor* Actor = EntryActors[EntryIndex].Get())
+		{
+			OutActors.Add(Actor);
+		}
+	}
+}
+
+bool UCombatTargetRegistry::MatchesObjectTypes(int32 EntryIndex, int32 QueryObjectTypes) const
+{
+	const AActor* Actor = EntryActors[EntryIndex].Get();
+	if (!Actor)
+	{
+		return false;
+	}
+
+	// read the collision state now, it changes after registration, e.g. when a dying enemy drops its capsule collision
+	TInlineComponentArray<UPrimitiveComponent*> Primitives(Actor);
+	for (const UPrimitiveComponent* Primitive : Primitives)
+	{
+		if (Primitive->IsQueryCollisionEnabled() && (QueryObjectTypes & ECC_TO_BITFIELD(Primitive->GetCollisionObjectType())) != 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UCombatTargetRegistry::QuerySegment(const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<int32>& OutEntries) const
+{
+	OutEntries.Reset();
+
+	// grow the query box by the largest target radius, since entries are hashed by their center only
+	const float Reach = Radius + MaxTargetRadius;
+	const FIntVector MinCell = GetCell(Start.ComponentMin(End) - FVector(Reach));
+	const FIntVector MaxCell = GetCell(Start.ComponentMax(End) + FVector(Reach));
+
+	// gather candidates into SoA scratch arrays, relative to Start so they fit in floats
+	const int32 QueryObjectTypes = ObjectParams.GetQueryBitfield();
+
+	TArray<int32, TInlineAllocator<64>> Candidates;
+	TArray<float, TInlineAllocator<64>> CandidateX;
+	TArray<float, TInlineAllocator<64>> CandidateY;
+	TArray<float, TInlineAllocator<64>> CandidateZ;
+	TArray<float, TInlineAllocator<64>> CandidateR;
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<int32>* Cell = Cells.Find(FIntVector(X, Y, Z));
+				if (!Cell)
+				{
+					continue;
+				}
+
+				for (const int32 EntryIndex : *Cell)
+				{
+					if (IgnoredActor && EntryActors[EntryIndex].Get() == IgnoredActor)
+					{
+						continue;
+					}
+
+					const FVector Relative = EntryCenters[EntryIndex] - Start;
+					Candidates.Add(EntryIndex);
+					CandidateX.Add(float(Relative.X));
+					CandidateY.Add(float(Relative.Y));
+					CandidateZ.Add(float(Relative.Z));
+					CandidateR.Add(EntryRadii[EntryIndex] + Radius);
+				}
+			}
+		}
+	}
+
+	const int32 NumCandidates = Candidates.Num();
+	if (NumCandidates == 0)
+	{
+		return;
+	}
+
+	// pad to a multiple of four with entries that can never pass
+	const int32 NumPadded = Align(NumCandidates, 4);
+	CandidateX.SetNumZeroed(NumPadded);
+	CandidateY.SetNumZeroed(NumPadded);
+	CandidateZ.SetNumZeroed(NumPadded);
+	CandidateR.SetNum(NumPadded);
+	for (int32 Index = NumCandidates; Index < NumPadded; ++Index)
+	{
+		CandidateR[Index] = -1.0f;
+	}
+
+	// closest point on the segment to each center: t = clamp(dot(P, D) / dot(D, D), 0, 1)
+	const FVector3f Direction = FVector3f(End - Start);
+	const float LengthSquared = Direction.SizeSquared();
+	const float InvLengthSquared = LengthSquared > UE_SMALL_NUMBER ? 1.0f / LengthSquared : 0.0f;
+
+	const VectorRegister4Float DirX = VectorSetFloat1(Direction.X);
+	const VectorRegister4Float DirY = VectorSetFloat1(Direction.Y);
+	const VectorRegister4Float DirZ = VectorSetFloat1(Direction.Z);
+	const VectorRegister4Float InvLenSq = VectorSetFloat1(InvLengthSquared);
+
+	for (int32 Index = 0; Index < NumPadded; Index += 4)
+	{
+		const VectorRegister4Float PX = VectorLoad(&CandidateX[Index]);
+		const VectorRegister4Float PY = VectorLoad(&CandidateY[Index]);
+		const VectorRegister4Float PZ = VectorLoad(&CandidateZ[Index]);
+		const VectorRegister4Float R = VectorLoad(&CandidateR[Index]);
+
+		VectorRegister4Float T = VectorMultiply(PX, DirX);
+		T = VectorMultiplyAdd(PY, DirY, T);
+		T = VectorMultiplyAdd(PZ, DirZ, T);
+		T = VectorMultiply(T, InvLenSq);
+		T = VectorMin(VectorMax(T, GlobalVectorConstants::FloatZero), GlobalVectorConstants::FloatOne);
+
+		const VectorRegister4Float DX = VectorNegateMultiplyAdd(T, DirX, PX);
+		const VectorRegister4Float DY = VectorNegateMultiplyAdd(T, DirY, PY);
+		const VectorRegister4Float DZ = VectorNegateMultiplyAdd(T, DirZ, PZ);
+
+		VectorRegister4Float DistSq = VectorMultiply(DX, DX);
+		DistSq = VectorMultiplyAdd(DY, DY, DistSq);
+		DistSq = VectorMultiplyAdd(DZ, DZ, DistSq);
+
+		// padded lanes have a negative radius and always fail the compare
+		const VectorRegister4Float Inside = VectorBitwiseAnd(VectorCompareLE(DistSq, VectorMultiply(R, R)), VectorCompareGE(R, GlobalVectorConstants::FloatZero));
+		const int32 Mask = VectorMaskBits(Inside);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			// object type filter on the few candidates that pass, same semantics as a SweepMultiByObjectType
+			if ((Mask & (1 << Lane)) && MatchesObjectTypes(Candidates[Index + Lane], QueryObjectTypes))
+			{
+				OutEntries.Add(Candidates[Index + Lane]);
+			}
+		}
+	}
+}
+
+bool UCombatTargetRegistry::SweepDamageables(const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<FHitResult>& OutHits) const
+{
+	OutHits.Reset();
+
+	TArray<int32> Entries;
+	QuerySegment(Start, End, Radius, ObjectParams, IgnoredActor, Entries);
+
+	const FCollisionShape CollisionShape = FCollisionShape::MakeSphere(Radius);
+	const int32 QueryObjectTypes = ObjectParams.GetQueryBitfield();
+
+	for (const int32 EntryIndex : Entries)
+	{
+		AActor* Actor = EntryActors[EntryIndex].Get();
+		if (!Actor)
+		{
+			continue;
+		}
+
+		// narrow phase against each of the candidate's components the physics sweep would have hit
+		TInlineComponentArray<UPrimitiveComponent*> Primitives(Actor);
+		for (UPrimitiveComponent* Primitive : Primitives)
+		{
+			if (!Primitive->IsQueryCollisionEnabled() || (QueryObjectTypes & ECC_TO_BITFIELD(Primitive->GetCollisionObjectType())) == 0)
+			{
+				continue;
+			}
+
+			FHitResult Hit;
+			CountCombatSceneQueries();
+			if (Primitive->SweepComponent(Hit, Start, End, FQuat::Identity, CollisionShape))
+			{
+				Hit.HitObjectHandle = FActorInstanceHandle(Actor);
+				Hit.Component = Primitive;
+				OutHits.Add(Hit);
+			}
+		}
+	}
+
+	// match the ordering of a physics sweep
+	OutHits.Sort([](const FHitResult& A, const FHitResult& B)
+	{
+		return A.Time < B.Time;
+	});
+
+	return OutHits.Num() > 0;
+}
@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "CombatTargetRegistry.generated.h"
+
+class AActor;
+class USceneComponent;
+class UPrimitiveComponent;
+struct FCollisionObjectQueryParams;
+
+/**
+ *  World subsystem that keeps every ICombatDamageable actor in a uniform spatial hash.
+ *  Melee and danger queries gather candidates from the overlapping hash cells and test their
+ *  bounding spheres four at a time with SIMD, and only go to physics to resolve the exact hit
+ *  on the few candidates that pass.
+ *  Entries are hashed by the bounds of the actor's root component, so collision on other components
+ *  that reaches well outside the root's bounds can be missed. Collision settings are read at query time.
+ */
+UCLASS()
+class UCombatTargetRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Returns the registry for the given world, or nullptr if the registry is disabled */
+	static UCombatTargetRegistry* Get(const UWorld* World);
+
+	/** Initializes the hash and starts listening for spawned actors */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Stops listening for spawned actors and drops all entries */
+	virtual void Deinitialize() override;
+
+	/** Registers the damageables that were placed in the level */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Only create the registry for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Adds a damageable actor to the registry. Called automatically for spawned and placed actors */
+	void RegisterTarget(AActor* Actor);
+
+	/** Removes an actor from the registry */
+	void UnregisterTarget(AActor* Actor);
+
+	/** Gathers registered actors whose bounding sphere overlaps the given sphere, without touching physics */
+	void QuerySphere(const FVector& Center, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<AActor*>& OutActors) const;
+
+	/** Gathers registered actors whose bounding sphere overlaps the capsule swept by a sphere from Start to End, without touching physics */
+	void QuerySweptSphere(const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<AActor*>& OutActors) const;
+
+	/**
+	 *  Replacement for SweepMultiByObjectType against damageables.
+	 *  Broad phase runs on the hash, then every primitive of each candidate whose current object type matches is swept
+	 *  on its own to produce the exact hits, one per component like a physics sweep.
+	 *  Returns true if anything was hit.
+	 */
+	bool SweepDamageables(const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<FHitResult>& OutHits) const;
+
+	/** Returns the number of registered targets */
+	int32 GetNumTargets() const { return EntryActors.Num(); }
+
+protected:
+
+	/** Registers actors as they spawn */
+	void OnActorSpawned(AActor* Actor);
+
+	/** Removes actors as they leave play */
+	UFUNCTION()
+	void OnTargetEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	/** Refreshes an entry when its root component moves */
+	void OnTargetMoved(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	/** Re-reads the bounds of an entry and moves it to its new cell if needed */
+	void UpdateEntry(int32 EntryIndex);
+
+	/** Returns the hash cell containing a location */
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** Returns true if any primitive of the entry currently has query collision and one of the queried object types */
+	bool MatchesObjectTypes(int32 EntryIndex, int32 QueryObjectTypes) const;
+
+	/** Broad phase shared by the sphere and swept sphere queries */
+	void QuerySegment(const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<int32>& OutEntries) const;
+
+	/** Edge length of a hash cell */
+	float CellSize = 400.0f;
+
+	/** Largest bounding radius seen so far, used to grow query bounds so big targets in neighboring cells are found */
+	float MaxTargetRadius = 0.0f;
+
+	/** Registered actors, one entry per index across the arrays below */
+	TArray<TWeakObjectPtr<AActor>> EntryActors;
+
+	/** Bounding sphere center of each entry */
+	TArray<FVector> EntryCenters;
+
+	/** Bounding sphere radius of each entry */
+	TArray<float> EntryRadii;
+
+	/** Hash cell each entry is currently stored in */
+	TArray<FIntVector> EntryCells;
+
+	/** Entry indices stored in each occupied cell */
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	/** Entry index of each registered actor */
+	TMap<const AActor*, int32> ActorToEntry;
+
+	/** Entry index of each watched root component */
+	TMap<const USceneComponent*, int32> ComponentToEntry;
+
+	/** Handle for the actor spawned callback */
+	FDelegateHandle ActorSpawnedHandle;
+};
@@ -6,6 +6,8 @@
 #include "UObject/Interface.h"
 #include "CombatAttacker.generated.h"
 
+struct FHitResult;
+
 /**
  *  CombatAttacker Interface
  *  Provides common functionality to trigger attack animation events.
@@ -33,4 +35,7 @@ public:
 	/** Performs a charged attack's check to loop the charge animation. Usually called from a montage's AnimNotify */
 	UFUNCTION(BlueprintCallable, Category="Attacker")
 	virtual void CheckChargedAttack() = 0;
+
+	/** Applies the hits found by an attack trace. Called by the attack trace queue once the batched traces for the frame are resolved */
+	virtual void ResolveAttackTrace(const TArray<FHitResult>& Hits) {}
 };
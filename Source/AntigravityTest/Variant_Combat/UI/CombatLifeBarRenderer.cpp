@@ -0,0 +1,178 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatLifeBarRenderer.h"
+#include "SCombatLifeBarOverlay.h"
+#include "Components/SceneComponent.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+static TAutoConsoleVariable<bool> CVarCombatLifeBarRendererEnabled(
+	TEXT("Combat.LifeBars.Batched"),
+	true,
+	TEXT("If true, combat life bars are drawn by a single screen-space overlay instead of a widget component per character. Read when characters begin play."));
+
+static TAutoConsoleVariable<float> CVarCombatLifeBarMaxDistance(
+	TEXT("Combat.LifeBars.MaxDistance"),
+	3000.0f,
+	TEXT("Life bars further than this from the camera, in cm, are not drawn."));
+
+UCombatLifeBarRenderer* UCombatLifeBarRenderer::Get(const UWorld* World)
+{
+	if (!World || !CVarCombatLifeBarRendererEnabled.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	return World->GetSubsystem<UCombatLifeBarRenderer>();
+}
+
+bool UCombatLifeBarRenderer::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatLifeBarRenderer::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// headless runs have no viewport to draw into
+	if (UGameViewportClient* GameViewport = InWorld.GetGameViewport())
+	{
+		Overlay = SNew(SCombatLifeBarOverlay).Renderer(this);
+		GameViewport->AddViewportWidgetContent(Overlay.ToSharedRef(), -1);
+	}
+}
+
+void UCombatLifeBarRenderer::Deinitialize()
+{
+	if (Overlay.IsValid())
+	{
+		if (UGameViewportClient* GameViewport = GetWorld()->GetGameViewport())
+		{
+			GameViewport->RemoveViewportWidgetContent(Overlay.ToSharedRef());
+		}
+
+		Overlay.Reset();
+	}
+
+	LifeBars.Empty();
+	LifeBarIndices.Empty();
+	DrawItems.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatLifeBarRenderer::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatLifeBarRenderer, STATGROUP_Tickables);
+}
+
+void UCombatLifeBarRenderer::AddLifeBar(const AActor* Owner, USceneComponent* Anchor, const FLinearColor& Color)
+{
+	if (!Owner || !Anchor)
+	{
+		return;
+	}
+
+	// re-adding an existing owner just refills its bar
+	if (const int32* LifeBarIndex = LifeBarIndices.Find(Owner))
+	{
+		FLifeBar& LifeBar = LifeBars[*LifeBarIndex];
+		LifeBar.Anchor = Anchor;
+		LifeBar.Percent = 1.0f;
+		LifeBar.Color = Color;
+		return;
+	}
+
+	FLifeBar& NewLifeBar = LifeBars.AddDefaulted_GetRef();
+	NewLifeBar.Owner = Owner;
+	NewLifeBar.Anchor = Anchor;
+	NewLifeBar.Color = Color;
+
+	LifeBarIndices.Add(Owner, LifeBars.Num() - 1);
+}
+
+void UCombatLifeBarRenderer::RemoveLifeBar(const AActor* Owner)
+{
+	if (const int32* LifeBarIndex = LifeBarIndices.Find(Owner))
+	{
+		RemoveLifeBarAt(*LifeBarIndex);
+	}
+}
+
+void UCombatLifeBarRenderer::RemoveLifeBarAt(int32 LifeBarIndex)
+{
+	LifeBarIndices.Remove(LifeBars[LifeBarIndex].Owner);
+
+	// the last bar moves into the freed slot
+	const int32 LastIndex = LifeBars.Num() - 1;
+	if (LifeBarIndex != LastIndex)
+	{
+		LifeBarIndices.Add(LifeBars[LastIndex].Owner, LifeBarIndex);
+	}
+	LifeBars.RemoveAtSwap(LifeBarIndex, 1, EAllowShrinking::No);
+}
+
+void UCombatLifeBarRenderer::SetLifePercentage(const AActor* Owner, float Percent)
+{
+	if (const int32* LifeBarIndex = LifeBarIndices.Find(Owner))
+	{
+		LifeBars[*LifeBarIndex].Percent = FMath::Clamp(Percent, 0.0f, 1.0f);
+	}
+}
+
+void UCombatLifeBarRenderer::Tick(float DeltaTime)
+{
+	DrawItems.Reset();
+
+	// bars are projected through the first local player's view
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->PlayerCameraManager || !Overlay.IsValid())
+	{
+		return;
+	}
+
+	int32 ViewportWidth = 0;
+	int32 ViewportHeight = 0;
+	PlayerController->GetViewportSize(ViewportWidth, ViewportHeight);
+
+	const FVector CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	const float MaxDistanceSquared = FMath::Square(CVarCombatLifeBarMaxDistance.GetValueOnGameThread());
+
+	for (int32 LifeBarIndex = LifeBars.Num() - 1; LifeBarIndex >= 0; --LifeBarIndex)
+	{
+		const FLifeBar& LifeBar = LifeBars[LifeBarIndex];
+		const USceneComponent* Anchor = LifeBar.Anchor.Get();
+
+		// drop bars whose owner went away without removing them
+		if (!Anchor)
+		{
+			RemoveLifeBarAt(LifeBarIndex);
+			continue;
+		}
+
+		// cull distant bars before paying for the projection
+		const FVector WorldLocation = Anchor->GetComponentLocation();
+		if (FVector::DistSquared(WorldLocation, CameraLocation) > MaxDistanceSquared)
+		{
+			continue;
+		}
+
+		// cull bars behind the camera or outside the viewport
+		FVector2D ScreenPosition;
+		if (!UGameplayStatics::ProjectWorldToScreen(PlayerController, WorldLocation, ScreenPosition, true)
+			|| ScreenPosition.X < 0.0f || ScreenPosition.Y < 0.0f || ScreenPosition.X > ViewportWidth || ScreenPosition.Y > ViewportHeight)
+		{
+			continue;
+		}
+
+		FCombatLifeBarDrawItem& DrawItem = DrawItems.AddDefaulted_GetRef();
+		DrawItem.ScreenPosition = ScreenPosition;
+		DrawItem.Percent = LifeBar.Percent;
+		DrawItem.Color = LifeBar.Color;
+	}
+}
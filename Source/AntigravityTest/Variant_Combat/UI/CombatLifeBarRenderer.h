@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatLifeBarRenderer.generated.h"
+
+class SCombatLifeBarOverlay;
+class USceneComponent;
+
+/**
+ *  A life bar that passed culling this frame, in viewport pixels
+ */
+struct FCombatLifeBarDrawItem
+{
+	/** Center of the bar in viewport pixels */
+	FVector2D ScreenPosition = FVector2D::ZeroVector;
+
+	/** Fill percentage, 0-1 */
+	float Percent = 1.0f;
+
+	/** Fill color */
+	FLinearColor Color = FLinearColor::White;
+};
+
+/**
+ *  World subsystem that draws every combat life bar in a single screen-space Slate overlay.
+ *  Characters register a scene component to anchor their bar to and push their HP percentage when it changes.
+ *  Each frame the bars are projected to the screen, off-screen and distant ones are culled,
+ *  and the overlay paints the survivors in one pass. This replaces a widget component per character.
+ */
+UCLASS()
+class UCombatLifeBarRenderer : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A registered life bar */
+	struct FLifeBar
+	{
+		/** Character that owns the bar */
+		const AActor* Owner = nullptr;
+
+		/** Component the bar is drawn above */
+		TWeakObjectPtr<USceneComponent> Anchor;
+
+		/** Fill percentage, 0-1 */
+		float Percent = 1.0f;
+
+		/** Fill color */
+		FLinearColor Color = FLinearColor::White;
+	};
+
+public:
+
+	/** Returns the renderer for the given world, or nullptr if it is disabled */
+	static UCombatLifeBarRenderer* Get(const UWorld* World);
+
+	/** Only create the renderer for game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Adds the overlay to the game viewport */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Removes the overlay from the game viewport */
+	virtual void Deinitialize() override;
+
+	/** Projects and culls the life bars */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Starts drawing a full life bar for the owner above the given component */
+	void AddLifeBar(const AActor* Owner, USceneComponent* Anchor, const FLinearColor& Color);
+
+	/** Stops drawing the owner's life bar */
+	void RemoveLifeBar(const AActor* Owner);
+
+	/** Updates the owner's life bar fill. Only touches the compact entry; nothing is redrawn per character */
+	void SetLifePercentage(const AActor* Owner, float Percent);
+
+	/** Returns the bars that passed culling this frame */
+	const TArray<FCombatLifeBarDrawItem>& GetDrawItems() const { return DrawItems; }
+
+	/** Returns the number of registered life bars */
+	int32 GetNumLifeBars() const { return LifeBars.Num(); }
+
+protected:
+
+	/** Removes the bar at the given index, keeping the index map in sync */
+	void RemoveLifeBarAt(int32 LifeBarIndex);
+
+	/** Registered life bars */
+	TArray<FLifeBar> LifeBars;
+
+	/** Maps each owner to its index in LifeBars */
+	TMap<const AActor*, int32> LifeBarIndices;
+
+	/** Bars that passed culling this frame */
+	TArray<FCombatLifeBarDrawItem> DrawItems;
+
+	/** Overlay widget in the game viewport */
+	TSharedPtr<SCombatLifeBarOverlay> Overlay;
+};
@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SCombatLifeBarOverlay.h"
+#include "CombatLifeBarRenderer.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+void SCombatLifeBarOverlay::Construct(const FArguments& InArgs)
+{
+	Renderer = InArgs._Renderer;
+	BarSize = InArgs._BarSize;
+	BackgroundColor = InArgs._BackgroundColor;
+}
+
+int32 SCombatLifeBarOverlay::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const UCombatLifeBarRenderer* RendererPtr = Renderer.Get();
+	if (!RendererPtr || RendererPtr->GetDrawItems().IsEmpty())
+	{
+		return LayerId;
+	}
+
+	const FSlateBrush* Brush = FCoreStyle::Get().GetBrush("WhiteBrush");
+	const FVector2f Size(BarSize);
+
+	for (const FCombatLifeBarDrawItem& DrawItem : RendererPtr->GetDrawItems())
+	{
+		// draw items are in viewport pixels, and the overlay covers the viewport
+		const FVector2f Center = FVector2f(AllottedGeometry.AbsoluteToLocal(AllottedGeometry.GetAbsolutePosition() + FVector2f(DrawItem.ScreenPosition)));
+		const FVector2f TopLeft = Center - Size * 0.5f;
+
+		// background
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId,
+			AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(TopLeft)),
+			Brush,
+			ESlateDrawEffect::None,
+			BackgroundColor);
+
+		// fill, one layer up so all fills batch together
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId + 1,
+			AllottedGeometry.ToPaintGeometry(FVector2f(Size.X * DrawItem.Percent, Size.Y), FSlateLayoutTransform(TopLeft)),
+			Brush,
+			ESlateDrawEffect::None,
+			DrawItem.Color);
+	}
+
+	return LayerId + 1;
+}
+
+FVector2D SCombatLifeBarOverlay::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D::ZeroVector;
+}
@@ -0,0 +1,55 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+class UCombatLifeBarRenderer;
+
+/**
+ *  Full-viewport Slate widget that paints every culled life bar from the life bar renderer.
+ *  All backgrounds go on one layer and all fills on the next, so Slate batches them into two draws.
+ */
+class SCombatLifeBarOverlay : public SLeafWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SCombatLifeBarOverlay)
+		: _BarSize(FVector2D(80.0f, 8.0f))
+		, _BackgroundColor(FLinearColor(0.0f, 0.0f, 0.0f, 0.6f))
+		{
+			_Visibility = EVisibility::HitTestInvisible;
+		}
+
+		/** Renderer that owns the draw list */
+		SLATE_ARGUMENT(TWeakObjectPtr<UCombatLifeBarRenderer>, Renderer)
+
+		/** Size of each bar in slate units */
+		SLATE_ARGUMENT(FVector2D, BarSize)
+
+		/** Color of the empty part of each bar */
+		SLATE_ARGUMENT(FLinearColor, BackgroundColor)
+
+	SLATE_END_ARGS()
+
+	/** Constructs the widget */
+	void Construct(const FArguments& InArgs);
+
+	/** Paints all life bars */
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+	/** The overlay fills whatever space it's given */
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+protected:
+
+	/** Renderer that owns the draw list */
+	TWeakObjectPtr<UCombatLifeBarRenderer> Renderer;
+
+	/** Size of each bar in slate units */
+	FVector2D BarSize;
+
+	/** Color of the empty part of each bar */
+	FLinearColor BackgroundColor;
+};
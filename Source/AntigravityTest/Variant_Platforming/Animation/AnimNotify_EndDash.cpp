@@ -4,9 +4,16 @@
 #include "AnimNotify_EndDash.h"
 #include "PlatformingCharacter.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Component/AnimNotifyRouterComponent.h"
 
 void UAnimNotify_EndDash::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
 {
+	// use the handler cached by the owner's notify router if it has one
+	if (UAnimNotifyRouterComponent::RouteNotify(MeshComp, EAnimNotifyRoute::EndDash))
+	{
+		return;
+	}
+
 	// cast the owner to the attacker interface
 	if (APlatformingCharacter* PlatformingCharacter = Cast<APlatformingCharacter>(MeshComp->GetOwner()))
 	{
@@ -13,6 +13,8 @@
 #include "EnhancedInputComponent.h"
 #include "TimerManager.h"
 #include "Engine/LocalPlayer.h"
+#include "Component/InputBufferComponent.h"
+#include "Component/AnimNotifyRouterComponent.h"
 
 APlatformingCharacter::APlatformingCharacter()
 {
@@ -76,6 +78,15 @@ APlatformingCharacter::APlatformingCharacter()
 	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
 	FollowCamera->bUsePawnControlRotation = false;
+
+	// create the input buffer and route replayed inputs to the input handlers
+	InputBuffer = CreateDefaultSubobject<UInputBufferComponent>(TEXT("InputBuffer"));
+	InputBuffer->OnReplayInput.AddUObject(this, &APlatformingCharacter::HandleReplayedInput);
+
+	// route the end dash notify from our mesh straight to its handler
+	NotifyRouter = CreateDefaultSubobject<UAnimNotifyRouterComponent>(TEXT("NotifyRouter"));
+	NotifyRouter->SetMesh(GetMesh());
+	NotifyRouter->SetRouteHandler(EAnimNotifyRoute::EndDash, FAnimNotifyRouteHandler::CreateWeakLambda(this, [this](FName) { EndDash(); }));
 }
 
 void APlatformingCharacter::Move(const FInputActionValue& Value)
@@ -101,11 +112,11 @@ void APlatformingCharacter::Dash()
 	DoDash();
 }
 
-void APlatformingCharacter::MultiJump()
+bool APlatformingCharacter::MultiJump()
 {
 	// ignore jumps while dashing
 	if(bIsDashing)
-		return;
+		return false;
 
 	// are we already in the air?
 	if (GetCharacterMovement()->IsFalling())
@@ -145,6 +156,8 @@ void APlatformingCharacter::MultiJump()
 				bHasWallJumped = true;
 
 				GetWorld()->GetTimerManager().SetTimer(WallJumpTimer, this, &APlatformingCharacter::ResetWallJump, DelayBetweenWallJumps, false);
+
+				return true;
 			}
 			// no wall jump, try a double jump next
 			else
@@ -160,6 +173,8 @@ void APlatformingCharacter::MultiJump()
 					// enable the jump trail
 					SetJumpTrailState(true);
 
+					return true;
+
 				// no coyote time jump
 				} else {
 
@@ -173,6 +188,8 @@ void APlatformingCharacter::MultiJump()
 
 						// enable the jump trail
 						SetJumpTrailState(true);
+
+						return true;
 					}
 
 				}
@@ -181,21 +198,26 @@ void APlatformingCharacter::MultiJump()
 			}
 		}
 
+		// no jump available in the air
+		return false;
 	}
-	else
-	{
-		// we're grounded so just do a regular jump
-		Jump();
 
-		// activate the jump trail
-		SetJumpTrailState(true);
-	}
+	// we're grounded so just do a regular jump
+	Jump();
+
+	// activate the jump trail
+	SetJumpTrailState(true);
+
+	return true;
 }
 
 void APlatformingCharacter::ResetWallJump()
 {
 	// reset the wall jump input lock
 	bHasWallJumped = false;
+
+	// perform a jump that was pressed during the lock
+	ConsumeBufferedInputs();
 }
 
 void APlatformingCharacter::DoMove(float Right, float Forward)
@@ -233,10 +255,23 @@ void APlatformingCharacter::DoLook(float Yaw, float Pitch)
 }
 
 void APlatformingCharacter::DoDash()
+{
+	// dash inputs trigger every frame while held, so only buffer one at a time
+	if (StartDash())
+	{
+		InputBuffer->RecordInput(EBufferedInputType::Dash);
+	}
+	else if (!InputBuffer->HasInput(EBufferedInputType::Dash, UInputBufferComponent::SecondsToFrames(DashBufferTime)))
+	{
+		InputBuffer->BufferInput(EBufferedInputType::Dash);
+	}
+}
+
+bool APlatformingCharacter::StartDash()
 {
 	// ignore the input if we've already dashed and have yet to reset
 	if (bHasDashed)
-		return;
+		return false;
 
 	// raise the dash flags
 	bIsDashing = true;
@@ -262,16 +297,62 @@ void APlatformingCharacter::DoDash()
 			AnimInstance->Montage_SetEndDelegate(OnDashMontageEnded, DashMontage);
 		}
 	}
+
+	return true;
+}
+
+void APlatformingCharacter::ConsumeBufferedInputs()
+{
+	// try a buffered jump first, then a buffered dash
+	if (InputBuffer->ConsumeInput(EBufferedInputType::Jump, UInputBufferComponent::SecondsToFrames(JumpBufferTime)))
+	{
+		MultiJump();
+	}
+	else if (InputBuffer->ConsumeInput(EBufferedInputType::Dash, UInputBufferComponent::SecondsToFrames(DashBufferTime)))
+	{
+		StartDash();
+	}
+}
+
+void APlatformingCharacter::HandleReplayedInput(EBufferedInputType Type)
+{
+	// route the replayed input the same way as live input
+	switch (Type)
+	{
+	case EBufferedInputType::Jump:
+		DoJumpStart();
+		break;
+
+	case EBufferedInputType::JumpRelease:
+		DoJumpEnd();
+		break;
+
+	case EBufferedInputType::Dash:
+		DoDash();
+		break;
+
+	default:
+		break;
+	}
 }
 
 void APlatformingCharacter::DoJumpStart()
 {
-	// handle special jump cases
-	MultiJump();
+	// handle special jump cases, buffering the jump if none could be performed
+	if (MultiJump())
+	{
+		InputBuffer->RecordInput(EBufferedInputType::Jump);
+	}
+	else
+	{
+		InputBuffer->BufferInput(EBufferedInputType::Jump);
+	}
 }
 
 void APlatformingCharacter::DoJumpEnd()
 {
+	InputBuffer->RecordInput(EBufferedInputType::JumpRelease);
+
 	// stop jumping
 	StopJumping();
 }
@@ -299,6 +380,9 @@ void APlatformingCharacter::EndDash()
 		// deactivate the jump trails
 		SetJumpTrailState(false);
 	}
+
+	// perform a jump or dash that was pressed during the dash
+	ConsumeBufferedInputs();
 }
 
 bool APlatformingCharacter::HasDoubleJumped() const
@@ -351,6 +435,9 @@ void APlatformingCharacter::Landed(const FHitResult& Hit)
 
 	// deactivate the jump trail
 	SetJumpTrailState(false);
+
+	// perform buffered inputs once the landing has finished resetting the jump state
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &APlatformingCharacter::ConsumeBufferedInputs);
 }
 
 void APlatformingCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode /*= 0*/)
@@ -13,6 +13,9 @@ class UCameraComponent;
 class UInputAction;
 struct FInputActionValue;
 class UAnimMontage;
+class UInputBufferComponent;
+class UAnimNotifyRouterComponent;
+enum class EBufferedInputType : uint8;
 
 /**
  *  An enhanced Third Person Character with the following functionality:
@@ -34,6 +37,14 @@ class APlatformingCharacter : public ACharacter
 	/** Follow camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* FollowCamera;
+
+	/** Buffers jump and dash inputs that arrive while they can't be performed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UInputBufferComponent* InputBuffer;
+
+	/** Routes gameplay anim notifies from the mesh without casting */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UAnimNotifyRouterComponent* NotifyRouter;
 	
 protected:
 
@@ -73,8 +84,17 @@ protected:
 	/** Called for dash input */
 	void Dash();
 
-	/** Called for jump pressed to check for advanced multi-jump conditions */
-	void MultiJump();
+	/** Called for jump pressed to check for advanced multi-jump conditions. Returns false if no jump could be performed */
+	bool MultiJump();
+
+	/** Starts a dash. Returns false if we've already dashed and have yet to reset */
+	bool StartDash();
+
+	/** Performs jump and dash inputs that were buffered while they couldn't be performed */
+	void ConsumeBufferedInputs();
+
+	/** Routes inputs replayed by the input buffer to the input handlers */
+	void HandleReplayedInput(EBufferedInputType Type);
 
 	/** Resets the wall jump input lock */
 	void ResetWallJump();
@@ -184,6 +204,14 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Coyote Time", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
 	float MaxCoyoteTime = 0.16f;
 
+	/** Max amount of time a jump pressed while it couldn't be performed is kept, e.g. right before landing */
+	UPROPERTY(EditAnywhere, Category="Input Buffer", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float JumpBufferTime = 0.15f;
+
+	/** Max amount of time a dash pressed while it couldn't be performed is kept */
+	UPROPERTY(EditAnywhere, Category="Input Buffer", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float DashBufferTime = 0.15f;
+
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
@@ -191,4 +219,7 @@ public:
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 
+	/** Returns InputBuffer subobject **/
+	FORCEINLINE class UInputBufferComponent* GetInputBuffer() const { return InputBuffer; }
+
 };
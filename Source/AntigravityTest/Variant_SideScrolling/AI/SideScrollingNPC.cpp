@@ -5,6 +5,7 @@
 #include "Engine/World.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "AI/AISignificanceManager.h"
 
 ASideScrollingNPC::ASideScrollingNPC()
 {
@@ -13,12 +14,29 @@ ASideScrollingNPC::ASideScrollingNPC()
 	GetCharacterMovement()->MaxWalkSpeed = 150.0f;
 }
 
+void ASideScrollingNPC::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// scale our tick rates by distance to the player
+	if (UAISignificanceManager* SignificanceManager = GetWorld()->GetSubsystem<UAISignificanceManager>())
+	{
+		SignificanceManager->RegisterAgent(this);
+	}
+}
+
 void ASideScrollingNPC::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
 	// clear the deactivation timer
 	GetWorld()->GetTimerManager().ClearTimer(DeactivationTimer);
+
+	// stop scaling our tick rates
+	if (UAISignificanceManager* SignificanceManager = GetWorld()->GetSubsystem<UAISignificanceManager>())
+	{
+		SignificanceManager->UnregisterAgent(this);
+	}
 }
 
 void ASideScrollingNPC::Interaction(AActor* Interactor)
@@ -32,6 +50,12 @@ void ASideScrollingNPC::Interaction(AActor* Interactor)
 	// reset the deactivation flag
 	bDeactivated = true;
 
+	// run at full rate while the launch plays out
+	if (UAISignificanceManager* SignificanceManager = GetWorld()->GetSubsystem<UAISignificanceManager>())
+	{
+		SignificanceManager->PromoteAgent(this);
+	}
+
 	// stop character movement immediately
 	GetCharacterMovement()->StopMovementImmediately();
 
@@ -6,12 +6,27 @@
 #include "StateTreeExecutionTypes.h"
 #include "AIController.h"
 #include "Kismet/GameplayStatics.h"
+#include "AI/PlayerPerceptionCache.h"
 
 EStateTreeRunStatus FStateTreeGetPlayerTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
+	// read the shared per-frame player snapshot if it's available
+	if (UPlayerPerceptionCache* PerceptionCache = IsValid(InstanceData.NPC) ? UPlayerPerceptionCache::Get(InstanceData.NPC->GetWorld()) : nullptr)
+	{
+		InstanceData.TargetPlayer = PerceptionCache->GetPlayerPawn(0);
+
+		// compare squared distances from the batched pass
+		if (IsValid(InstanceData.TargetPlayer))
+		{
+			InstanceData.bValidTarget = PerceptionCache->GetDistanceSquaredToPlayer(InstanceData.NPC) < FMath::Square(InstanceData.RangeMax);
+		}
+
+		return EStateTreeRunStatus::Running;
+	}
+
 	// set the player pawn as the target
 	InstanceData.TargetPlayer = UGameplayStatics::GetPlayerPawn(InstanceData.Controller.Get(), 0);
 
@@ -13,6 +13,7 @@
 #include "SideScrollingInteractable.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "TimerManager.h"
+#include "Component/InputBufferComponent.h"
 
 ASideScrollingCharacter::ASideScrollingCharacter()
 {
@@ -24,6 +25,10 @@ ASideScrollingCharacter::ASideScrollingCharacter()
 
 	Camera->SetRelativeLocationAndRotation(FVector(0.0f, 300.0f, 0.0f), FRotator(0.0f, -90.0f, 0.0f));
 
+	// create the input buffer and route replayed inputs to the input handlers
+	InputBuffer = CreateDefaultSubobject<UInputBufferComponent>(TEXT("InputBuffer"));
+	InputBuffer->OnReplayInput.AddUObject(this, &ASideScrollingCharacter::HandleReplayedInput);
+
 	// configure the collision capsule
 	GetCapsuleComponent()->SetCapsuleSize(35.0f, 90.0f);
 
@@ -119,6 +124,9 @@ void ASideScrollingCharacter::Landed(const FHitResult& Hit)
 {
 	// reset the double jump
 	bHasDoubleJumped = false;
+
+	// perform a buffered jump once the landing has finished resetting the jump state
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ASideScrollingCharacter::ConsumeBufferedJump);
 }
 
 void ASideScrollingCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode /*= 0*/)
@@ -177,12 +185,21 @@ void ASideScrollingCharacter::DoDrop(float Value)
 
 void ASideScrollingCharacter::DoJumpStart()
 {
-	// handle advanced jump behaviors
-	MultiJump();
+	// handle advanced jump behaviors, buffering the jump if none could be performed
+	if (MultiJump())
+	{
+		InputBuffer->RecordInput(EBufferedInputType::Jump);
+	}
+	else
+	{
+		InputBuffer->BufferInput(EBufferedInputType::Jump);
+	}
 }
 
 void ASideScrollingCharacter::DoJumpEnd()
 {
+	InputBuffer->RecordInput(EBufferedInputType::JumpRelease);
+
 	StopJumping();
 }
 
@@ -215,13 +232,13 @@ void ASideScrollingCharacter::DoInteract()
 	}
 }
 
-void ASideScrollingCharacter::MultiJump()
+bool ASideScrollingCharacter::MultiJump()
 {
 	// does the user want to drop to a lower platform?
 	if (DropValue > 0.0f)
 	{
 		CheckForSoftCollision();
-		return;
+		return true;
 	}
 
 	// reset the drop value
@@ -231,7 +248,7 @@ void ASideScrollingCharacter::MultiJump()
 	if (!GetCharacterMovement()->IsFalling())
 	{
 		Jump();
-		return;
+		return true;
 	}
 
 	// if we have a horizontal input, try for wall jump first
@@ -267,7 +284,7 @@ void ASideScrollingCharacter::MultiJump()
 			// schedule wall jump lockout reset
 			GetWorld()->GetTimerManager().SetTimer(WallJumpTimer, this, &ASideScrollingCharacter::ResetWallJump, DelayBetweenWallJumps, false);
 
-			return;
+			return true;
 		}
 	}
 
@@ -284,6 +301,8 @@ void ASideScrollingCharacter::MultiJump()
 			// use the built-in CMC functionality to do the jump
 			Jump();
 
+			return true;
+
 		// no coyote time jump
 		} else {
 		
@@ -295,9 +314,14 @@ void ASideScrollingCharacter::MultiJump()
 
 				// let the CMC handle jump
 				Jump();
+
+				return true;
 			}
 		}
 	}
+
+	// no jump available
+	return false;
 }
 
 void ASideScrollingCharacter::CheckForSoftCollision()
@@ -331,6 +355,35 @@ void ASideScrollingCharacter::ResetWallJump()
 {
 	// reset the wall jump flag
 	bHasWallJumped = false;
+
+	// perform a jump that was pressed during the lockout
+	ConsumeBufferedJump();
+}
+
+void ASideScrollingCharacter::ConsumeBufferedJump()
+{
+	if (InputBuffer->ConsumeInput(EBufferedInputType::Jump, UInputBufferComponent::SecondsToFrames(JumpBufferTime)))
+	{
+		MultiJump();
+	}
+}
+
+void ASideScrollingCharacter::HandleReplayedInput(EBufferedInputType Type)
+{
+	// route the replayed input the same way as live input
+	switch (Type)
+	{
+	case EBufferedInputType::Jump:
+		DoJumpStart();
+		break;
+
+	case EBufferedInputType::JumpRelease:
+		DoJumpEnd();
+		break;
+
+	default:
+		break;
+	}
 }
 
 void ASideScrollingCharacter::SetSoftCollision(bool bEnabled)
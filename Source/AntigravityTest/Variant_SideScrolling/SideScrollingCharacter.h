@@ -9,6 +9,8 @@
 class UCameraComponent;
 class UInputAction;
 struct FInputActionValue;
+class UInputBufferComponent;
+enum class EBufferedInputType : uint8;
 
 /**
  *  A player-controllable character side scrolling game
@@ -22,6 +24,10 @@ class ASideScrollingCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category ="Camera", meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* Camera;
 
+	/** Buffers jump inputs that arrive while no jump can be performed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category ="Input", meta = (AllowPrivateAccess = "true"))
+	UInputBufferComponent* InputBuffer;
+
 protected:
 
 	/** Move Input Action */
@@ -79,6 +85,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Side Scrolling|Coyote Time", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
 	float MaxCoyoteTime = 0.16f;
 
+	/** Max amount of time a jump pressed while it couldn't be performed is kept, e.g. right before landing */
+	UPROPERTY(EditAnywhere, Category="Side Scrolling|Input Buffer", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float JumpBufferTime = 0.15f;
+
 	/** Wall jump lockout timer */
 	FTimerHandle WallJumpTimer;
 
@@ -154,8 +164,14 @@ public:
 
 protected:
 
-	/** Handles advanced jump logic */
-	void MultiJump();
+	/** Handles advanced jump logic. Returns false if no jump could be performed */
+	bool MultiJump();
+
+	/** Performs a jump that was buffered while it couldn't be performed */
+	void ConsumeBufferedJump();
+
+	/** Routes inputs replayed by the input buffer to the input handlers */
+	void HandleReplayedInput(EBufferedInputType Type);
 
 	/** Checks for soft collision with platforms */
 	void CheckForSoftCollision();